@@ -10,6 +10,7 @@
 #include <alps/hdf5/vector.hpp>
 
 #include <alps/accumulators/wrappers.hpp>
+#include <alps/accumulators/handle.hpp>
 // #include <alps/accumulators/feature/weight_holder.hpp>
 #include <alps/accumulators/wrapper_set.hpp>
 
@@ -390,19 +391,6 @@ namespace alps {
         result_wrapper cbrt (result_wrapper const & arg);
 
         class accumulator_wrapper {
-            private:
-
-                /// Check if the data is valid (not a 0-sized vector): Generic.
-                template <typename T>
-                static void check_nonempty_vector(const T&) {}
-
-                /// Check if the data is valid (not a 0-sized vector): vector specialization.
-                /** @note Throws on a failed check */
-                template <typename T>
-                static void check_nonempty_vector(const std::vector<T>& vec) {
-                    if (vec.empty()) throw std::runtime_error("Zero-sized vector observables are not allowed");
-                }
-
             public:
             /// default constructor
             accumulator_wrapper();
@@ -443,7 +431,7 @@ namespace alps {
                 };
             public:
                 template<typename T> void operator()(T const & value) {
-                    check_nonempty_vector(value);
+                    detail::check_nonempty_vector(value);
                     boost::apply_visitor(call_1_visitor<T>(value), m_variant);
                 }
                 template<typename T> accumulator_wrapper & operator<<(T const & value) {
@@ -451,9 +439,45 @@ namespace alps {
                     return (*this);
                 }
 
+            // add_many(T const *, std::size_t)
+            private:
+                template<typename T> struct add_many_visitor: public boost::static_visitor<> {
+                    add_many_visitor(T const * d, std::size_t sz) : data(d), n(sz) {}
+                    template<typename X> void apply(typename std::enable_if<
+                        std::is_same<T, typename value_type<X>::type>::value, X &
+                    >::type arg) const {
+                        arg.add_many(data, n);
+                    }
+                    template<typename X> void apply(typename std::enable_if<!
+                        std::is_same<T, typename value_type<X>::type>::value, X &
+                    >::type /*arg*/) const {
+                        throw std::logic_error(std::string("cannot add a block of ") + typeid(T).name() + " to " + typeid(typename value_type<X>::type).name() + ALPS_STACKTRACE);
+                    }
+                    template<typename X> void operator()(X & arg) const {
+                        check_ptr(arg);
+                        apply<typename X::element_type>(*arg);
+                    }
+                    T const * data;
+                    std::size_t n;
+                };
+            public:
+                /// Add a block of `n` values; gives the same result as adding them one by one.
+                /** @note The value type `T` must match the accumulator value type exactly */
+                template<typename T> void add_many(T const * data, std::size_t n) {
+                    for (std::size_t j = 0; j < n; ++j) detail::check_nonempty_vector(data[j]);
+                    boost::apply_visitor(add_many_visitor<T>(data, n), m_variant);
+                }
+                /// Add all values in the vector
+                template<typename T> void add_many(std::vector<T> const & values) {
+                    add_many(values.data(), values.size());
+                }
+
                 /// Merge another accumulator into this one. @param rhs_acc  accumulator to merge.
                 void merge(const accumulator_wrapper& rhs_acc);
 
+                /// Whether `rhs_acc` wraps an accumulator of the same concrete type
+                bool has_same_type(const accumulator_wrapper& rhs_acc) const;
+
                 /// Returns a copy with the wrapped accumulator cloned
                 accumulator_wrapper clone() const;
 
@@ -500,6 +524,21 @@ namespace alps {
                     return *boost::apply_visitor(visitor, m_variant);
                 }
 
+            // handle
+            public:
+                /// Return a typed handle feeding samples to the wrapped accumulator without the variant dispatch
+                /** @tparam X value type (e.g. `double`), named accumulator (e.g. `FullBinningAccumulator<double>`)
+                              or raw accumulator type; see `accumulator_handle` for details.
+                    @note Throws if the wrapped accumulator does not match `X`.
+                */
+                template <typename X> accumulator_handle<X> handle() {
+                    typedef typename accumulator_handle<X>::value_type value_type;
+                    get_visitor<value_type> visitor;
+                    boost::apply_visitor(visitor, m_variant);
+                    check_ptr(visitor.value);
+                    return accumulator_handle<X>(visitor.value);
+                }
+
             // mean, error
             #define ALPS_ACCUMULATOR_PROPERTY_PROXY(PROPERTY, TYPE)                                                 \
                 private:                                                                                            \
@@ -546,6 +585,8 @@ namespace alps {
 
 #ifdef ALPS_HAVE_MPI
             void collective_merge(alps::mpi::communicator const & comm, int root);
+            /// one step of a merge of many accumulators, @see alps::alps_mpi::merge_buffer
+            void collective_merge(alps_mpi::merge_buffer & buffer);
 #endif
 
             private:
@@ -570,5 +611,23 @@ namespace alps {
         typedef impl::wrapper_set<accumulator_wrapper> accumulator_set;
         typedef impl::wrapper_set<result_wrapper> result_set;
 
+#ifdef ALPS_HAVE_MPI
+        /// Merge the named accumulators of a set over all ranks, using a fixed number of MPI collective operations
+        /** Has the same effect as `collective_merge(comm, root)` on each of the named accumulators
+            that has been measured on all ranks: on the `root` rank, the accumulators held by `set`
+            receive the merged data; on the other ranks, they are reset. The number of MPI collective
+            operations does not depend on the number of accumulators.
+
+            @param names the accumulators to merge, in the same order on all ranks
+            @returns the names of the merged accumulators; accumulators with no measurements
+                     on any rank are skipped
+            @throws std::runtime_error if an accumulator has measurements on some, but not all, ranks
+        */
+        std::vector<std::string> collective_merge(alps::mpi::communicator const & comm,
+                                                  accumulator_set const & set,
+                                                  std::vector<std::string> const & names,
+                                                  int root);
+#endif
+
     }
 }
@@ -98,6 +98,9 @@ namespace alps {
                 ) const {
                     throw std::logic_error("A result cannot be merged " + ALPS_STACKTRACE);
                 }
+                inline void collective_merge(alps::alps_mpi::merge_buffer & /*buffer*/) {
+                    throw std::logic_error("A result cannot be merged " + ALPS_STACKTRACE);
+                }
 #endif
 
                 template<typename U> void operator+=(U const &) {}
@@ -109,6 +109,7 @@ namespace alps {
 
                     using B::operator();
                     void operator()(T const & val);
+                    void add_many(T const * data, std::size_t n);
 
                     template<typename S> void print(S & os, bool terse=false) const {
                         if (terse) {
@@ -165,10 +166,21 @@ namespace alps {
                           alps::mpi::communicator const & comm
                         , int root
                     ) const;
+                    /// One step of a merge of many accumulators, @see alps::alps_mpi::merge_buffer
+                    void collective_merge(alps::alps_mpi::merge_buffer & buffer);
 #endif
 
                 private:
 
+                    /// Update the binning levels with a value, `cnt` being the count including this value
+                    void add_to_levels(T const & val, typename count_type<B>::type cnt);
+
+                    /// Append a binning level shaped like `val`, with the given partial bin
+                    void add_level(T const & val, T const & partial);
+
+                    /// Partial bin of every level, as saved: the sum of the samples after the last completed bin
+                    std::vector<T> partial_bins() const;
+
                     std::vector<T> m_ac_sum;
                     std::vector<T> m_ac_sum2;
                     std::vector<T> m_ac_partial;
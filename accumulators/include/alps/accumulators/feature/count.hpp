@@ -83,6 +83,8 @@ namespace alps {
                         throw std::runtime_error("No values can be added to a result" + ALPS_STACKTRACE);
                     }
 
+                    void add_many(T const *, std::size_t);
+
                     template<typename S> void print(S & os, bool /*terse*/=false) const {
                         os << " #" << alps::short_print(count());
                     }
@@ -175,6 +177,11 @@ namespace alps {
                     void operator()(T const &) {
                         ++m_count;
                     }
+
+                    /// Add a block of `n` values; equivalent to `n` calls of `operator()`
+                    void add_many(T const * /*data*/, std::size_t n) {
+                        m_count += n;
+                    }
                     template<typename W> void operator()(T const &, W) {
                         throw std::runtime_error("Observable has no binary call operator" + ALPS_STACKTRACE);
                     }
@@ -209,6 +216,8 @@ namespace alps {
                           alps::mpi::communicator const & comm
                         , int root
                     ) const;
+                    /// One step of a merge of many accumulators, @see alps::alps_mpi::merge_buffer
+                    void collective_merge(alps::alps_mpi::merge_buffer & buffer);
 #endif
 
                 private:
@@ -87,6 +87,7 @@ namespace alps {
 
                     using B::operator();
                     void operator()(T const & val);
+                    void add_many(T const * data, std::size_t n);
 
                     template<typename S> void print(S & os, bool terse=false) const {
                         B::print(os, terse);
@@ -124,6 +125,8 @@ namespace alps {
                           alps::mpi::communicator const & comm
                         , int root
                     ) const;
+                    /// One step of a merge of many accumulators, @see alps::alps_mpi::merge_buffer
+                    void collective_merge(alps::alps_mpi::merge_buffer & buffer);
 #endif
 
                 private:
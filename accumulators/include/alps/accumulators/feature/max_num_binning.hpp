@@ -28,6 +28,8 @@
 #include <boost/utility.hpp>
 #include <boost/function.hpp>
 
+#include <algorithm>
+#include <memory>
 #include <stdexcept>
 #include <type_traits>
 
@@ -38,6 +40,8 @@ namespace alps {
         struct max_num_binning_tag;
 
         namespace detail {
+            /// Bins, bin size and maximum number of bins of a full-binning accumulator or result
+            /** Refers to bins stored as `std::vector<M>`; bins materialized from another storage are owned (shared by copies). */
             template<typename C, typename M> class max_num_binning_proxy {
                 typedef typename std::size_t size_type;
 
@@ -45,11 +49,19 @@ namespace alps {
                 max_num_binning_proxy(std::vector<M> const & bins, C const & num_elements, size_type const & max_number)
                     : m_max_number(max_number)
                     , m_num_elements(num_elements)
-                    , m_bins(bins)
+                    , m_owned()
+                    , m_bins(&bins)
+                {}
+
+                max_num_binning_proxy(std::vector<M> && bins, C const & num_elements, size_type const & max_number)
+                    : m_max_number(max_number)
+                    , m_num_elements(num_elements)
+                    , m_owned(std::make_shared<std::vector<M> >(std::move(bins)))
+                    , m_bins(m_owned.get())
                 {}
 
                 std::vector<M> const & bins() const {
-                    return m_bins;
+                    return *m_bins;
                 }
 
                 C num_elements() const {
@@ -62,6 +74,7 @@ namespace alps {
 
                 std::ostream& print(std::ostream& os, bool terse) const
                 {
+                    std::vector<M> const & m_bins = *this->m_bins;
                     if (m_bins.empty()) {
                         os << "No Bins";
                         return os;
@@ -81,12 +94,144 @@ namespace alps {
 
                 size_type m_max_number;
                 C m_num_elements;
-                std::vector<M> const & m_bins;
+                std::shared_ptr<const std::vector<M> > m_owned;
+                std::vector<M> const * m_bins;
             };
 
             template<typename C, typename M> inline std::ostream & operator<<(std::ostream & os, max_num_binning_proxy<C, M> const & arg) {
                 return arg.print(os,true);
             };
+
+            /// Bins of a full-binning accumulator: generic case, one object per bin
+            template<typename M> class max_num_binning_bins {
+              public:
+                typedef M bin_type;
+
+                std::size_t size() const { return m_bins.size(); }
+                bool empty() const { return m_bins.empty(); }
+                void clear() { m_bins.clear(); }
+                void reserve(std::size_t nbins) { m_bins.reserve(nbins); }
+
+                /// Check that a value is size-compatible with the bins (throws if not)
+                template<typename T> void check_size(T const & val) {
+                    if (!m_bins.empty()) alps::numeric::check_size(m_bins[0], val);
+                }
+
+                void push_back(M const & val) { m_bins.push_back(val); }
+
+                /// Append a new bin `sum / divisor`
+                template<typename T, typename S> void push_back_divided(T const & sum, S const & divisor) {
+                    using alps::numeric::operator/;
+                    m_bins.push_back(sum / divisor);
+                }
+
+                /// Add bin `i`, weighted by `weight`, to `target`
+                template<typename S> void add_bin_to(std::size_t i, S const & weight, M & target) const {
+                    alps::numeric::axpy(target, weight, m_bins[i]);
+                }
+
+                /// Replace the first `nbins/2` bins by the pairwise averages of the first `nbins` bins; drop the rest
+                template<typename S> void rebin(std::size_t nbins, S const & two) {
+                    using alps::numeric::operator+;
+                    using alps::numeric::operator/;
+                    for (std::size_t i = 0; i < nbins / 2; ++i)
+                        m_bins[i] = (m_bins[2 * i] + m_bins[2 * i + 1]) / two;
+                    m_bins.erase(m_bins.begin() + nbins / 2, m_bins.end());
+                }
+
+                std::vector<M> const & to_vector() const { return m_bins; }
+
+                /// Replace the bins, keeping room for `capacity` bins
+                void assign(std::vector<M> const & bins, std::size_t capacity) {
+                    m_bins = bins;
+                    m_bins.reserve(capacity);
+                }
+
+              private:
+                std::vector<M> m_bins;
+            };
+
+            /// Bins of a full-binning accumulator of vectors: contiguous row-major (bin x element) storage
+            template<typename S> class max_num_binning_bins< std::vector<S> > {
+              public:
+                typedef std::vector<S> bin_type;
+
+                max_num_binning_bins(): m_data(), m_bin_size(0), m_size(0) {}
+
+                std::size_t size() const { return m_size; }
+                bool empty() const { return m_size == 0; }
+                void clear() { m_data.clear(); m_size = 0; }
+                void reserve(std::size_t nbins) { m_data.reserve(nbins * m_bin_size); }
+
+                /// Check that a value is size-compatible with the bins (throws if not)
+                void check_size(bin_type const & val) const {
+                    if (m_size != 0 && val.size() != m_bin_size)
+                        throw std::runtime_error("vectors must have the same size!" + ALPS_STACKTRACE);
+                }
+
+                void push_back(bin_type const & val) {
+                    if (m_size == 0) m_bin_size = val.size();
+                    m_data.insert(m_data.end(), val.begin(), val.end());
+                    ++m_size;
+                }
+
+                /// Append a new bin `sum / divisor`
+                /** Multiplies by the reciprocal, which is exact for the power-of-two bin sizes of the binning. */
+                template<typename D> void push_back_divided(bin_type const & sum, D const & divisor) {
+                    if (m_size == 0) m_bin_size = sum.size();
+                    m_data.insert(m_data.end(), sum.begin(), sum.end());
+                    alps::numeric::scale_inplace(&m_data[m_size * m_bin_size], D(1) / divisor, m_bin_size);
+                    ++m_size;
+                }
+
+                /// Add bin `i`, weighted by `weight`, to `target`
+                template<typename W> void add_bin_to(std::size_t i, W const & weight, bin_type & target) const {
+                    if (target.size() != m_bin_size)
+                        throw std::runtime_error("vectors must have the same size!" + ALPS_STACKTRACE);
+                    alps::numeric::axpy(target.data(), weight, &m_data[i * m_bin_size], m_bin_size);
+                }
+
+                /// Replace the first `nbins/2` bins by the pairwise averages of the first `nbins` bins; drop the rest
+                /** Done in place: bin `i` is written after bins `2i` and `2i+1` are read. */
+                template<typename D> void rebin(std::size_t nbins, D const & two) {
+                    S * data = m_data.data();
+                    const D half = D(1) / two;
+                    for (std::size_t i = 0; i < nbins / 2; ++i) {
+                        S * out = data + i * m_bin_size;
+                        S const * lhs = data + 2 * i * m_bin_size;
+                        if (out != lhs) std::copy(lhs, lhs + m_bin_size, out);
+                        alps::numeric::axpy(out, D(1), lhs + m_bin_size, m_bin_size);
+                        alps::numeric::scale_inplace(out, half, m_bin_size);
+                    }
+                    m_size = nbins / 2;
+                    m_data.resize(m_size * m_bin_size);
+                }
+
+                std::vector<bin_type> to_vector() const {
+                    std::vector<bin_type> bins(m_size);
+                    for (std::size_t i = 0; i < m_size; ++i)
+                        bins[i].assign(m_data.begin() + i * m_bin_size, m_data.begin() + (i + 1) * m_bin_size);
+                    return bins;
+                }
+
+                /// Replace the bins, keeping room for `capacity` bins
+                void assign(std::vector<bin_type> const & bins, std::size_t capacity) {
+                    clear();
+                    if (!bins.empty()) {
+                        m_bin_size = bins[0].size();
+                        reserve(capacity > bins.size() ? capacity : bins.size());
+                    }
+                    for (std::size_t i = 0; i < bins.size(); ++i) {
+                        check_size(bins[i]);
+                        push_back(bins[i]);
+                    }
+                }
+
+              private:
+                std::vector<S> m_data;
+                std::size_t m_bin_size;
+                std::size_t m_size;
+            };
         }
 
         template<typename T> struct max_num_binning_type {
@@ -161,7 +306,7 @@ namespace alps {
                 {}
 
                 max_num_binning_type const max_num_binning() const {
-                    return max_num_binning_type(m_mn_bins, m_mn_elements_in_bin, m_mn_max_number);
+                    return max_num_binning_type(m_mn_bins.to_vector(), m_mn_elements_in_bin, m_mn_max_number);
                 }
 
                 template <typename OP> void transform(OP) {
@@ -174,6 +319,7 @@ namespace alps {
 
                 using B::operator();
                 void operator()(T const & val);
+                void add_many(T const * data, std::size_t n);
 
                 template<typename S> void print(S & os, bool terse=false) const {
                     if (terse) {
@@ -221,19 +367,35 @@ namespace alps {
                 void collective_merge(alps::mpi::communicator const & comm,
                                       int root) const;
 
+                /// One step of a merge of many accumulators, @see alps::alps_mpi::merge_buffer
+                void collective_merge(alps::alps_mpi::merge_buffer & buffer);
+
               private:
                 void partition_bins(alps::mpi::communicator const & comm,
                                     std::vector<typename mean_type<B>::type> & local_bins,
                                     std::vector<typename mean_type<B>::type> & merged_bins,
                                     int /*root*/) const;
+
+                /// Average groups of local bins to make them as large as bins of `elements_in_bins` elements
+                void rebin_local_bins(std::vector<typename mean_type<B>::type> & local_bins,
+                                      typename B::count_type elements_in_local_bins) const;
+
+                /// Spread the local bins, the first of which is bin number `start` out of `total_bins`, over the merged bins
+                void spread_bins(std::vector<typename mean_type<B>::type> const & local_bins,
+                                 std::vector<typename mean_type<B>::type> & merged_bins,
+                                 std::size_t start,
+                                 std::size_t total_bins) const;
 #endif
 
               private:
 
+                /// Update the bins with a value
+                void add_to_bins(T const & val);
+
                 std::size_t m_mn_max_number;
                 typename B::count_type m_mn_elements_in_bin, m_mn_elements_in_partial;
                 T m_mn_partial;
-                std::vector<typename mean_type<B>::type> m_mn_bins;
+                detail::max_num_binning_bins<typename mean_type<B>::type> m_mn_bins;
             };
 
 
@@ -262,10 +424,16 @@ namespace alps {
                 {}
 
                 template<typename A> Result(A const & acc, typename std::enable_if<!std::is_base_of<ResultBase<T>, A>::value, int>::type = 0)
+                    : Result(acc, detail::max_num_binning_impl(acc))
+                {}
+
+              private:
+                // the bins of the accumulator are materialized only once
+                template<typename A> Result(A const & acc, max_num_binning_type const & mnb)
                     : B(acc)
-                    , m_mn_max_number(detail::max_num_binning_impl(acc).max_number())
-                    , m_mn_elements_in_bin(detail::max_num_binning_impl(acc).num_elements())
-                    , m_mn_bins(detail::max_num_binning_impl(acc).bins())
+                    , m_mn_max_number(mnb.max_number())
+                    , m_mn_elements_in_bin(mnb.num_elements())
+                    , m_mn_bins(mnb.bins())
                     , m_mn_count(acc.count())
                     , m_mn_mean(acc.mean())
                     , m_mn_error(acc.error())
@@ -275,6 +443,7 @@ namespace alps {
                     , m_mn_jackknife_bins(0)
                 {}
 
+              public:
                 typename B::count_type count() const;
                 typename mean_type<B>::type const & mean() const;
                 typename error_type<B>::type const & error() const;
@@ -350,6 +519,15 @@ namespace alps {
                         *it = op(*it, *jt);
                 }
 
+                /// Nonlinear transform that rewrites the bins in place as `op(bins, jackknife_bins)`
+                template <typename OP> void transform_bins(OP op) {
+                    generate_jackknife();
+                    m_mn_data_is_analyzed = false;
+                    m_mn_cannot_rebin = true;
+                    op(m_mn_bins, m_mn_jackknife_bins);
+                    analyze();
+                }
+
                 void sin();
                 void cos();
                 void tan();
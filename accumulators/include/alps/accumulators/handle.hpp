@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file handle.hpp
+    Typed handles to accumulators held in an `accumulator_set`.
+
+    Feeding a sample via `measurements["name"] << x` costs a map lookup,
+    a variant dispatch and a virtual call per sample. A handle resolves
+    the first two once:
+    @code
+        accumulator_set measurements;
+        measurements << FullBinningAccumulator<double>("Energy");
+
+        // virtual call per sample:
+        accumulator_handle<double> h1=measurements.handle<double>("Energy");
+        // direct (non-virtual) call per sample:
+        auto h2=measurements.handle< FullBinningAccumulator<double> >("Energy");
+
+        h1 << 1.0;
+        h2 << 2.0;
+    @endcode
+
+    @note A handle shares ownership of the wrapped accumulator: it stays
+          valid while the set is modified, but it keeps feeding the old
+          accumulator if the `accumulator_wrapper` in the set is re-assigned.
+          Loading the set from an archive (e.g. on a checkpoint restart)
+          loads in place into accumulators of the same type, so their
+          handles stay valid; an accumulator of a different type in the
+          archive replaces the old one and orphans its handles.
+*/
+
+#pragma once
+
+#include <alps/config.hpp>
+#include <alps/accumulators/wrappers.hpp>
+
+#include <memory>
+#include <type_traits>
+
+namespace alps {
+    namespace accumulators {
+
+        namespace detail {
+
+            /// Raw accumulator type addressed by a handle of `X`, or `void` if `X` is a value type
+            template<typename X> struct handle_accumulator_type {
+                private:
+                    // X is a named accumulator
+                    template<typename U> static typename U::accumulator_type check(typename U::accumulator_type *);
+                    // X is a raw accumulator or a value type
+                    template<typename U> static typename std::conditional<impl::is_accumulator<U>::value, U, void>::type check(...);
+                public:
+                    typedef decltype(check<X>(0)) type;
+            };
+
+            /// Handle implementation: concrete raw accumulator type A, direct call
+            template<typename X, typename A> class handle_impl {
+                public:
+                    typedef typename value_type<A>::type value_type;
+                    typedef A accumulator_type;
+
+                    explicit handle_impl(std::shared_ptr<base_wrapper<value_type> > const & wrapper)
+                        : m_wrapper(wrapper)
+                        , m_target(&wrapper->template extract<A>())
+                    {}
+
+                    void operator()(value_type const & value) {
+                        check_nonempty_vector(value);
+                        (*m_target)(value);
+                    }
+
+                    void add_many(value_type const * data, std::size_t n) {
+                        for (std::size_t j = 0; j < n; ++j) check_nonempty_vector(data[j]);
+                        m_target->add_many(data, n);
+                    }
+
+                    /// Access the raw accumulator
+                    accumulator_type & accumulator() const { return *m_target; }
+
+                private:
+                    std::shared_ptr<base_wrapper<value_type> > m_wrapper;
+                    accumulator_type * m_target;
+            };
+
+            /// Handle implementation: value type T, virtual call
+            template<typename T> class handle_impl<T, void> {
+                public:
+                    typedef T value_type;
+
+                    explicit handle_impl(std::shared_ptr<base_wrapper<value_type> > const & wrapper)
+                        : m_wrapper(wrapper)
+                    {}
+
+                    void operator()(value_type const & value) {
+                        check_nonempty_vector(value);
+                        (*m_wrapper)(value);
+                    }
+
+                    void add_many(value_type const * data, std::size_t n) {
+                        for (std::size_t j = 0; j < n; ++j) check_nonempty_vector(data[j]);
+                        m_wrapper->add_many(data, n);
+                    }
+
+                private:
+                    std::shared_ptr<base_wrapper<value_type> > m_wrapper;
+            };
+        }
+
+        /// Typed handle to an accumulator, bypassing the name lookup and the variant dispatch
+        /** @tparam X either the value type of the accumulator (e.g., `double`): the samples
+                      are fed through one virtual call; or the named accumulator type
+                      (e.g., `FullBinningAccumulator<double>`) or the raw accumulator type:
+                      the samples are fed directly to the accumulator.
+
+            Obtain handles via `accumulator_set::handle<X>(name)` or `accumulator_wrapper::handle<X>()`.
+        */
+        template<typename X> class accumulator_handle
+            : public detail::handle_impl<X, typename detail::handle_accumulator_type<X>::type>
+        {
+                typedef detail::handle_impl<X, typename detail::handle_accumulator_type<X>::type> base_type;
+            public:
+                typedef typename base_type::value_type value_type;
+
+                explicit accumulator_handle(std::shared_ptr<base_wrapper<value_type> > const & wrapper)
+                    : base_type(wrapper)
+                {}
+
+                accumulator_handle & operator<<(value_type const & value) {
+                    (*this)(value);
+                    return *this;
+                }
+        };
+    }
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file lazy.hpp
+    Deferred arithmetic on results: an expression graph evaluated in a single pass over the jackknife bins
+*/
+
+#pragma once
+
+#include <alps/config.hpp>
+#include <alps/accumulators/accumulator.hpp>
+
+#include <memory>
+
+namespace alps {
+    namespace accumulators {
+
+        namespace detail {
+            class expression_node;
+        }
+
+        /// Arithmetic expression of results, evaluated only by evaluate()
+        /**
+            Each operator on result_wrapper copies its operands' bins and jackknife bins and
+            analyzes the result again. A result_expression instead records the operations and
+            evaluates the whole expression bin by bin, allocating only the final result:
+
+            @code
+                const result_wrapper& mag4=results["Magnetization^4"];
+                const result_wrapper& mag2=results["Magnetization^2"];
+                result_expression m4=lazy(mag4), m2=lazy(mag2);
+                result_wrapper binder_cumulant=(1-m4/(3*m2*m2)).evaluate();
+            @endcode
+
+            The fused evaluation applies when all results are `FullBinningAccumulator<double>` results;
+            otherwise evaluate() falls back to the result_wrapper operators.
+
+            @note The expression refers to the results it was built from, they must outlive it.
+        */
+        class result_expression {
+            public:
+                typedef std::shared_ptr<detail::expression_node const> node_ptr;
+
+                /// Expression consisting of a single result
+                explicit result_expression(result_wrapper const & res);
+
+                explicit result_expression(node_ptr const & node) : m_node(node) {}
+
+                /// Evaluate the expression into a new result
+                result_wrapper evaluate() const;
+
+                node_ptr const & node() const { return m_node; }
+
+            private:
+                node_ptr m_node;
+        };
+
+        /// Start a deferred expression from a result
+        inline result_expression lazy(result_wrapper const & res) {
+            return result_expression(res);
+        }
+
+        result_expression operator-(result_expression const & arg);
+
+        #define ALPS_ACCUMULATOR_EXPRESSION_OPERATOR(OPNAME)                                      \
+            result_expression OPNAME (result_expression const & lhs, result_expression const & rhs); \
+            result_expression OPNAME (result_expression const & lhs, long double rhs);            \
+            result_expression OPNAME (long double lhs, result_expression const & rhs);
+        ALPS_ACCUMULATOR_EXPRESSION_OPERATOR(operator+)
+        ALPS_ACCUMULATOR_EXPRESSION_OPERATOR(operator-)
+        ALPS_ACCUMULATOR_EXPRESSION_OPERATOR(operator*)
+        ALPS_ACCUMULATOR_EXPRESSION_OPERATOR(operator/)
+        #undef ALPS_ACCUMULATOR_EXPRESSION_OPERATOR
+
+        result_expression sin (result_expression const & arg);
+        result_expression cos (result_expression const & arg);
+        result_expression tan (result_expression const & arg);
+        result_expression sinh (result_expression const & arg);
+        result_expression cosh (result_expression const & arg);
+        result_expression tanh (result_expression const & arg);
+        result_expression asin (result_expression const & arg);
+        result_expression acos (result_expression const & arg);
+        result_expression atan (result_expression const & arg);
+        result_expression abs (result_expression const & arg);
+        result_expression sqrt (result_expression const & arg);
+        result_expression log (result_expression const & arg);
+        result_expression sq (result_expression const & arg);
+        result_expression cb (result_expression const & arg);
+        result_expression cbrt (result_expression const & arg);
+    }
+}
@@ -12,12 +12,117 @@
 
     #include <alps/utilities/boost_mpi.hpp>
 
+    #include <boost/cstdint.hpp>
+
+    #include <type_traits>
+    #include <utility>
+    #include <vector>
+
     namespace alps {
         namespace alps_mpi {
 
             template<typename T, typename Op> void reduce(const alps::mpi::communicator & comm, T const & in_values, Op op, int root);
             template<typename T, typename Op> void reduce(const alps::mpi::communicator & comm, T const & in_values, T & out_values, Op op, int root);
 
+            /// Buffers to merge many accumulators over MPI ranks with a fixed number of collective operations
+            /** The merge proceeds in phases. In each phase the accumulators are visited in the same
+                order on all ranks, and each accumulator reads and writes its entries in the same order:
+                - `shape_phase`: sizes the ranks must agree upon, via `put_shape()`;
+                  they are reduced by maximum;
+                - `layout_phase`: the agreed sizes, via `get_shape()`, and the numbers of local bins,
+                  via `put_layout()`; they are turned into the position of the local bins among the
+                  bins of all ranks and the total number of bins;
+                - `pack_phase`: the agreed sizes and layouts, via `get_layout()`, and the data,
+                  via `pack()` or `transfer()`; the data are summed up on the root rank;
+                - `unpack_phase` (root only): as `pack_phase`, but the summed up data are read back
+                  via `unpack()` or `transfer()`.
+
+                @see alps::accumulators::collective_merge()
+            */
+            class merge_buffer {
+                public:
+                    typedef boost::uint64_t size_type;
+                    enum phase_type { shape_phase, layout_phase, pack_phase, unpack_phase, done_phase };
+
+                    merge_buffer(): m_phase(shape_phase), m_shape_pos(0), m_layout_pos(0) {}
+
+                    phase_type phase() const { return m_phase; }
+
+                    /// Append a size to be reduced by maximum (shape phase)
+                    void put_shape(size_type size) { m_shape.push_back(size); }
+                    /// Read the next reduced size (later phases)
+                    size_type get_shape() { return m_shape.at(m_shape_pos++); }
+
+                    /// Current position in the sizes; the sizes of an accumulator are read back after `seek_shape()` to it
+                    std::size_t shape_position() const { return m_shape.size(); }
+                    void seek_shape(std::size_t pos) { m_shape_pos = pos; }
+
+                    /// Append the number of bins on this rank (layout phase)
+                    void put_layout(size_type nbins) { m_layout.push_back(nbins); }
+                    /// Read the next layout: the number of bins on the lower ranks and the total number of bins (later phases)
+                    std::pair<size_type, size_type> get_layout() {
+                        std::pair<size_type, size_type> layout(m_layout_offset.at(m_layout_pos), m_layout_total.at(m_layout_pos));
+                        ++m_layout_pos;
+                        return layout;
+                    }
+
+                    /// Append a value (a scalar or a nested vector) to be summed up
+                    template<typename T> void pack(T const & value) { pack_impl(value); }
+                    /// Read back a summed up value into `value`, which must have the right size already
+                    template<typename T> void unpack(T & value) { unpack_impl(value); }
+                    /// Pack `value` in the pack phase, unpack into it in the unpack phase
+                    template<typename T> void transfer(T & value) {
+                        if (m_phase == pack_phase)
+                            pack_impl(value);
+                        else if (m_phase == unpack_phase)
+                            unpack_impl(value);
+                    }
+
+                    /// Finish the current phase: run its collective operation and start the next phase
+                    void finish_phase(alps::mpi::communicator const & comm, int root);
+
+                private:
+                    template<typename S> struct data_buffer {
+                        data_buffer(): pos(0) {}
+                        std::vector<S> values;
+                        std::size_t pos;
+                    };
+
+                    data_buffer<boost::uint64_t> & data(boost::uint64_t *) { return m_counts; }
+                    data_buffer<float> & data(float *) { return m_floats; }
+                    data_buffer<double> & data(double *) { return m_doubles; }
+                    data_buffer<long double> & data(long double *) { return m_long_doubles; }
+
+                    template<typename S> typename std::enable_if<std::is_arithmetic<S>::value>::type pack_impl(S const & value) {
+                        data(static_cast<S *>(0)).values.push_back(value);
+                    }
+                    template<typename U> void pack_impl(std::vector<U> const & value) {
+                        for (typename std::vector<U>::const_iterator it = value.begin(); it != value.end(); ++it)
+                            pack_impl(*it);
+                    }
+
+                    template<typename S> typename std::enable_if<std::is_arithmetic<S>::value>::type unpack_impl(S & value) {
+                        data_buffer<S> & buf = data(static_cast<S *>(0));
+                        value = buf.values.at(buf.pos++);
+                    }
+                    template<typename U> void unpack_impl(std::vector<U> & value) {
+                        for (typename std::vector<U>::iterator it = value.begin(); it != value.end(); ++it)
+                            unpack_impl(*it);
+                    }
+
+                    template<typename S> void reduce_data(alps::mpi::communicator const & comm, data_buffer<S> & buf, int root);
+
+                    phase_type m_phase;
+                    std::vector<size_type> m_shape;
+                    std::size_t m_shape_pos;
+                    std::vector<size_type> m_layout, m_layout_offset, m_layout_total;
+                    std::size_t m_layout_pos;
+                    data_buffer<boost::uint64_t> m_counts;
+                    data_buffer<float> m_floats;
+                    data_buffer<double> m_doubles;
+                    data_buffer<long double> m_long_doubles;
+            };
+
         } // alps_mpi::
     } // alps::
 
@@ -17,6 +17,7 @@ namespace alps {
 
         class accumulator_wrapper;
         class result_wrapper;
+        template<typename X> class accumulator_handle;
 
         namespace detail {
             template<typename T> struct serializable_type;
@@ -86,6 +87,17 @@ namespace alps {
                         }
                     }
 
+                    /// Return a typed handle to the named accumulator, resolved once. @see accumulator_handle
+                    /** @note Throws `std::out_of_range` if there is no accumulator with this name */
+                    template<typename X, typename U = T>
+                    typename std::enable_if<std::is_same<U, accumulator_wrapper>::value, accumulator_handle<X> >::type
+                    handle(std::string const & name) {
+                        iterator it = m_storage.find(name);
+                        if (it == end())
+                            throw std::out_of_range("No observable found with the name: " + name + ALPS_STACKTRACE);
+                        return it->second->template handle<X>();
+                    }
+
                     template<typename U = T>
                     typename std::enable_if<std::is_same<U, accumulator_wrapper>::value>::type
                     reset() {
@@ -32,6 +32,17 @@ namespace alps {
             template<typename T> struct value_wrapper {
                 typedef T value_type;
             };
+
+            /// Check if the data is valid (not a 0-sized vector): Generic.
+            template <typename T>
+            inline void check_nonempty_vector(const T&) {}
+
+            /// Check if the data is valid (not a 0-sized vector): vector specialization.
+            /** @note Throws on a failed check */
+            template <typename T>
+            inline void check_nonempty_vector(const std::vector<T>& vec) {
+                if (vec.empty()) throw std::runtime_error("Zero-sized vector observables are not allowed");
+            }
         }
 
         template<typename T> class base_wrapper : public
@@ -51,6 +62,8 @@ namespace alps {
                 virtual ~base_wrapper() {}
 
                 virtual void operator()(value_type const & value) = 0;
+                /// add a block of `n` values
+                virtual void add_many(value_type const * data, std::size_t n) = 0;
                 // virtual void operator()(value_type const & value, detail::weight_variant_type const & weight) = 0;
 
                 virtual void save(hdf5::archive & ar) const = 0;
@@ -63,6 +76,8 @@ namespace alps {
                 virtual void merge(const base_wrapper<T>&) = 0;
 #ifdef ALPS_HAVE_MPI
                 virtual void collective_merge(alps::mpi::communicator const & comm, int root) = 0;
+                /// one step of a merge of many accumulators, @see alps::alps_mpi::merge_buffer
+                virtual void collective_merge(alps::alps_mpi::merge_buffer & buffer) = 0;
 #endif
 
                 virtual base_wrapper * clone() const = 0;
@@ -189,6 +204,10 @@ namespace alps {
                     this->m_data(value);
                 }
 
+                void add_many(value_type const * data, std::size_t n) {
+                    this->m_data.add_many(data, n);
+                }
+
             public:
                 void save(hdf5::archive & ar) const {
                     ar[""] = this->m_data;
@@ -225,6 +244,10 @@ namespace alps {
                 ) const {
                     this->m_data.collective_merge(comm, root);
                 }
+
+                void collective_merge(alps::alps_mpi::merge_buffer & buffer) {
+                    this->m_data.collective_merge(buffer);
+                }
 #endif
         };
 
@@ -6,6 +6,7 @@
 
 #include <alps/accumulators/accumulator.hpp>
 #include <sstream>
+#include <typeinfo>
 
 namespace alps {
     namespace accumulators {
@@ -54,6 +55,25 @@ namespace alps {
             boost::apply_visitor(visitor, m_variant);
         }
 
+        //
+        // has_same_type
+        //
+
+        struct same_type_visitor: public boost::static_visitor<bool> {
+            same_type_visitor(const detail::variant_type& r): rhs(r) {}
+            template <typename P> // P can be dereferenced to base_wrapper<T>
+            bool operator()(P const & lhs_ptr) const
+            {
+                const P* rhs_ptr=boost::get<P>(&rhs);
+                if (!rhs_ptr || !*rhs_ptr || !lhs_ptr) return false;
+                return typeid(*lhs_ptr)==typeid(**rhs_ptr);
+            }
+            const detail::variant_type& rhs;
+        };
+        bool accumulator_wrapper::has_same_type(const accumulator_wrapper& rhs_acc) const {
+            return boost::apply_visitor(same_type_visitor(rhs_acc.m_variant), m_variant);
+        }
+
         //
         // clone / new_clone
         //
@@ -211,6 +231,67 @@ namespace alps {
             boost::apply_visitor(collective_merge_visitor(comm, root), m_variant);
             if (comm.rank()!=root) this->reset();
         }
+
+        struct collective_merge_buffer_visitor: public boost::static_visitor<> {
+            collective_merge_buffer_visitor(alps_mpi::merge_buffer & b): buffer(b) {}
+            template<typename T> void operator()(T & arg) const { arg->collective_merge(buffer); }
+            alps_mpi::merge_buffer & buffer;
+        };
+
+        void accumulator_wrapper::collective_merge(alps_mpi::merge_buffer & buffer) {
+            boost::apply_visitor(collective_merge_buffer_visitor(buffer), m_variant);
+        }
+
+        std::vector<std::string> collective_merge(alps::mpi::communicator const & comm,
+                                                  accumulator_set const & set,
+                                                  std::vector<std::string> const & names,
+                                                  int root)
+        {
+            // copies share the accumulators held by the set
+            std::vector<accumulator_wrapper> accs;
+            accs.reserve(names.size());
+            for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+                accs.push_back(set[*it]);
+
+            // each accumulator starts its shape by two flags: measured on some rank, not measured on some rank
+            alps_mpi::merge_buffer buffer;
+            std::vector<std::size_t> positions(accs.size());
+            for (std::size_t i = 0; i < accs.size(); ++i) {
+                positions[i] = buffer.shape_position();
+                bool has_count = accs[i].count() > 0;
+                buffer.put_shape(has_count);
+                buffer.put_shape(!has_count);
+                accs[i].collective_merge(buffer);
+            }
+            buffer.finish_phase(comm, root);
+
+            std::vector<std::size_t> merged;
+            for (std::size_t i = 0; i < accs.size(); ++i) {
+                buffer.seek_shape(positions[i]);
+                bool measured = buffer.get_shape();
+                bool unmeasured = buffer.get_shape();
+                if (measured && unmeasured)
+                    throw std::runtime_error(names[i] + " was measured on only some of the MPI processes." + ALPS_STACKTRACE);
+                if (measured)
+                    merged.push_back(i);
+            }
+
+            while (buffer.phase() != alps_mpi::merge_buffer::done_phase) {
+                for (std::vector<std::size_t>::const_iterator it = merged.begin(); it != merged.end(); ++it) {
+                    buffer.seek_shape(positions[*it] + 2);
+                    accs[*it].collective_merge(buffer);
+                }
+                buffer.finish_phase(comm, root);
+            }
+
+            std::vector<std::string> merged_names;
+            for (std::vector<std::size_t>::const_iterator it = merged.begin(); it != merged.end(); ++it) {
+                if (comm.rank() != root)
+                    accs[*it].reset();
+                merged_names.push_back(names[*it]);
+            }
+            return merged_names;
+        }
 #endif
 
         //
@@ -180,37 +180,88 @@ namespace alps {
 
             template<typename T, typename B>
             void Accumulator<T, binning_analysis_tag, B>::operator()(T const & val) {
+                B::operator()(val);
+                add_to_levels(val, B::count());
+            }
+
+            template<typename T, typename B>
+            void Accumulator<T, binning_analysis_tag, B>::add_many(T const * data, std::size_t n) {
+                B::add_many(data, n);
+                // the count as it was before the block
+                typename count_type<B>::type cnt = B::count() - n;
+                for (std::size_t j = 0; j < n; ++j)
+                    add_to_levels(data[j], ++cnt);
+            }
+
+            // Levels are updated as a cascade: only level 0 sees every sample, and a
+            // completed bin of level i-1 is added to the partial bin of level i.
+            // Level i is touched once per 2^(i-1) samples, so a sample costs O(1)
+            // vector operations instead of one per level.
+            //
+            // m_ac_partial[i] (i > 0) holds the completed level i-1 bins of the
+            // current level i bin, and m_ac_partial[0] stays 0. The full partial
+            // bin of level i is the prefix sum m_ac_partial[1] + ... + m_ac_partial[i],
+            // which is what is saved; see partial_bins().
+            template<typename T, typename B>
+            void Accumulator<T, binning_analysis_tag, B>::add_to_levels(T const & val, typename count_type<B>::type cnt) {
                 using alps::numeric::operator+=;
-                using alps::numeric::operator*;
+                using alps::numeric::add_sq_inplace;
+                using alps::numeric::set_zero;
                 using alps::numeric::check_size;
 
-                B::operator()(val);
-                if(B::count() == (1UL << m_ac_sum2.size())) {
-                    m_ac_sum2.push_back(T());
-                    check_size(m_ac_sum2.back(), val);
-                    m_ac_sum.push_back(T());
-                    check_size(m_ac_sum.back(), val);
-                    m_ac_partial.push_back(m_ac_sum[0]);
-                    check_size(m_ac_partial.back(), val);
-                    m_ac_count.push_back(typename count_type<B>::type());
-                }
+                if (m_ac_sum2.empty())
+                    add_level(val, T());
                 BOOST_ASSERT_MSG(m_ac_partial.size() >= m_ac_sum2.size(), "m_ac_partial is as large as m_ac_sum2");
                 BOOST_ASSERT_MSG(m_ac_count.size() >= m_ac_sum2.size(), "m_ac_count is as large as m_ac_sum2");
                 BOOST_ASSERT_MSG(m_ac_sum.size() >= m_ac_sum2.size(), "m_ac_sum is as large as m_ac_sum2");
-                for (unsigned i = 0; i < m_ac_sum2.size(); ++i) {
-                    m_ac_partial[i] += val;
-
-                    // in other words: (B::count() % (1L << i) == 0)
-                    if (!(B::count() & ((1ll << i) - 1))) {
-                        m_ac_sum2[i] += m_ac_partial[i] * m_ac_partial[i];
-                        m_ac_sum[i] += m_ac_partial[i];
-                        m_ac_count[i]++;
-                        m_ac_partial[i] = T();
-                        check_size(m_ac_partial[i], val);
+
+                // level 0: every sample is a bin
+                add_sq_inplace(m_ac_sum2[0], val);
+                m_ac_sum[0] += val;
+                m_ac_count[0]++;
+                if (m_ac_sum2.size() > 1)
+                    m_ac_partial[1] += val;
+
+                // levels whose bin is completed by this sample, in other words: (cnt % (1L << i) == 0)
+                for (unsigned i = 1; !(cnt & ((1ll << i) - 1)); ++i) {
+                    if (i == m_ac_sum2.size()) {
+                        // levels are only added at cnt == 2^i (not after a merge changed the count)
+                        if (cnt != (1ll << i))
+                            break;
+                        // the first bin of the new level holds all samples so far
+                        add_level(val, m_ac_sum[i - 1]);
                     }
+                    add_sq_inplace(m_ac_sum2[i], m_ac_partial[i]);
+                    m_ac_sum[i] += m_ac_partial[i];
+                    m_ac_count[i]++;
+                    if (i + 1 < m_ac_sum2.size())
+                        m_ac_partial[i + 1] += m_ac_partial[i];
+                    set_zero(m_ac_partial[i]);
                 }
             }
 
+            template<typename T, typename B>
+            void Accumulator<T, binning_analysis_tag, B>::add_level(T const & val, T const & partial) {
+                using alps::numeric::check_size;
+                // `partial` may refer to an element of m_ac_sum: copy it before m_ac_sum grows
+                m_ac_partial.push_back(partial);
+                check_size(m_ac_partial.back(), val);
+                m_ac_sum2.push_back(T());
+                check_size(m_ac_sum2.back(), val);
+                m_ac_sum.push_back(T());
+                check_size(m_ac_sum.back(), val);
+                m_ac_count.push_back(typename count_type<B>::type());
+            }
+
+            template<typename T, typename B>
+            std::vector<T> Accumulator<T, binning_analysis_tag, B>::partial_bins() const {
+                using alps::numeric::operator+=;
+                std::vector<T> partial(m_ac_partial);
+                for (std::size_t i = 2; i < partial.size(); ++i)
+                    partial[i] += partial[i - 1];
+                return partial;
+            }
+
             template<typename T, typename B>
             void Accumulator<T, binning_analysis_tag, B>::save(hdf5::archive & ar) const {
                 B::save(ar);
@@ -218,7 +269,7 @@ namespace alps {
                     ar["tau/partialbin"] = m_ac_sum;
                 ar["tau/data"] = m_ac_sum2;
                 ar["tau/ac_count"] = m_ac_count; // FIXME: proper dataset name? to be saved always?
-                ar["tau/ac_partial"] = m_ac_partial;  // FIXME: proper dataset name? to be saved always?
+                ar["tau/ac_partial"] = partial_bins();  // FIXME: proper dataset name? to be saved always?
             }
 
             template<typename T, typename B>
@@ -229,8 +280,16 @@ namespace alps {
                 ar["tau/data"] >> m_ac_sum2;
                 if (ar.is_data("tau/ac_count"))
                     ar["tau/ac_count"] >> m_ac_count; // FIXME: proper dataset name?
-                if (ar.is_data("tau/ac_partial"))
+                if (ar.is_data("tau/ac_partial")) {
                     ar["tau/ac_partial"] >> m_ac_partial;  // FIXME: proper dataset name?
+                    // back from full partial bins to the cascade; see add_to_levels()
+                    using alps::numeric::operator-;
+                    using alps::numeric::set_zero;
+                    for (std::size_t i = m_ac_partial.size(); i-- > 2; )
+                        m_ac_partial[i] = m_ac_partial[i] - m_ac_partial[i - 1];
+                    if (!m_ac_partial.empty())
+                        set_zero(m_ac_partial[0]);
+                }
             }
 
             template<typename T, typename B>
@@ -309,6 +368,41 @@ namespace alps {
                     }
                 }
             }
+
+            template<typename T, typename B>
+            void Accumulator<T, binning_analysis_tag, B>::collective_merge(alps::alps_mpi::merge_buffer & buffer) {
+                typedef alps::alps_mpi::merge_buffer merge_buffer;
+
+                B::collective_merge(buffer);
+                if (buffer.phase() == merge_buffer::shape_phase) {
+                    buffer.put_shape(m_ac_count.size());
+                    return;
+                }
+                std::size_t size = buffer.get_shape();
+                if (buffer.phase() == merge_buffer::pack_phase) {
+                    // pad copies: the levels of this accumulator must stay as they are
+                    std::vector<typename count_type<B>::type> count(m_ac_count);
+                    count.resize(size);
+                    buffer.pack(count);
+                    std::vector<T> sum(m_ac_sum);
+                    sum.resize(size);
+                    alps::numeric::rectangularize(sum);
+                    buffer.pack(sum);
+                    std::vector<T> sum2(m_ac_sum2);
+                    sum2.resize(size);
+                    alps::numeric::rectangularize(sum2);
+                    buffer.pack(sum2);
+                } else if (buffer.phase() == merge_buffer::unpack_phase) {
+                    m_ac_count.resize(size);
+                    buffer.unpack(m_ac_count);
+                    m_ac_sum.resize(size);
+                    alps::numeric::rectangularize(m_ac_sum);
+                    buffer.unpack(m_ac_sum);
+                    m_ac_sum2.resize(size);
+                    alps::numeric::rectangularize(m_ac_sum2);
+                    buffer.unpack(m_ac_sum2);
+                }
+            }
 #endif
 
             #define ALPS_ACCUMULATOR_INST_BINNING_ANALYSIS_ACC(r, data, T)                         \
@@ -39,13 +39,19 @@ namespace alps {
 
             template<typename T, typename B>
             void Accumulator<T, error_tag, B>::operator()(T const & val) {
-                using alps::numeric::operator*;
-                using alps::numeric::operator+=;
-                using alps::numeric::check_size;
+                using alps::numeric::add_sq_inplace;
 
                 B::operator()(val);
-                check_size(m_sum2, val);
-                m_sum2 += val * val;
+                add_sq_inplace(m_sum2, val);
+            }
+
+            template<typename T, typename B>
+            void Accumulator<T, error_tag, B>::add_many(T const * data, std::size_t n) {
+                using alps::numeric::add_sq_inplace;
+
+                B::add_many(data, n);
+                for (std::size_t j = 0; j < n; ++j)
+                    add_sq_inplace(m_sum2, data[j]);
             }
 
             template<typename T, typename B>
@@ -100,6 +106,12 @@ namespace alps {
                 else
                     B::reduce_if(comm, m_sum2, std::plus<typename alps::hdf5::scalar_type<T>::type>(), root);
             }
+
+            template<typename T, typename B>
+            void Accumulator<T, error_tag, B>::collective_merge(alps::alps_mpi::merge_buffer & buffer) {
+                B::collective_merge(buffer);
+                buffer.transfer(m_sum2);
+            }
 #endif
 
             #define ALPS_ACCUMULATOR_INST_ERROR_ACC(r, data, T)                                    \
@@ -42,18 +42,31 @@ namespace alps {
 
             template<typename T, typename B>
             void Accumulator<T, max_num_binning_tag, B>::operator()(T const & val) {
+                B::operator()(val);
+                add_to_bins(val);
+            }
+
+            template<typename T, typename B>
+            void Accumulator<T, max_num_binning_tag, B>::add_many(T const * data, std::size_t n) {
+                B::add_many(data, n);
+                for (std::size_t j = 0; j < n; ++j)
+                    add_to_bins(data[j]);
+            }
+
+            template<typename T, typename B>
+            void Accumulator<T, max_num_binning_tag, B>::add_to_bins(T const & val) {
                 using alps::numeric::operator+=;
                 using alps::numeric::operator+;
                 using alps::numeric::operator/;
                 using alps::numeric::check_size;
-
-                B::operator()(val);
+                using alps::numeric::set_zero;
 
                 if (!m_mn_elements_in_bin) {
                     m_mn_bins.push_back(val);
+                    m_mn_bins.reserve(m_mn_max_number + 1);
                     m_mn_elements_in_bin = 1;
                 } else {
-                    check_size(m_mn_bins[0], val);
+                    m_mn_bins.check_size(val);
                     check_size(m_mn_partial, val);
                     m_mn_partial += val;
                     ++m_mn_elements_in_partial;
@@ -65,17 +78,17 @@ namespace alps {
 
                 if (m_mn_elements_in_partial == m_mn_elements_in_bin && m_mn_bins.size() >= m_mn_max_number) {
                     if (m_mn_max_number % 2 == 1) {
-                        m_mn_partial += m_mn_bins[m_mn_max_number - 1];
+                        // the last bin is a mean: fold its sum into the partial bin
+                        m_mn_bins.add_bin_to(m_mn_max_number - 1, elements_in_bin, m_mn_partial);
                         m_mn_elements_in_partial += m_mn_elements_in_bin;
                     }
-                    for (typename count_type<T>::type i = 0; i < m_mn_max_number / 2; ++i)
-                        m_mn_bins[i] = (m_mn_bins[2 * i] + m_mn_bins[2 * i + 1]) / two;
-                    m_mn_bins.erase(m_mn_bins.begin() + m_mn_max_number / 2, m_mn_bins.end());
+                    m_mn_bins.rebin(m_mn_max_number, two);
                     m_mn_elements_in_bin *= (typename count_type<T>::type)2;
+                    elements_in_bin = m_mn_elements_in_bin;
                 }
                 if (m_mn_elements_in_partial == m_mn_elements_in_bin) {
-                    m_mn_bins.push_back(m_mn_partial / elements_in_bin);
-                    m_mn_partial = T();
+                    m_mn_bins.push_back_divided(m_mn_partial, elements_in_bin);
+                    set_zero(m_mn_partial);
                     m_mn_elements_in_partial = 0;
                 }
             }
@@ -87,7 +100,7 @@ namespace alps {
                     ar["timeseries/partialbin"] = m_mn_partial;
                     ar["timeseries/partialbin/@count"] = m_mn_elements_in_partial;
                 }
-                ar["timeseries/data"] = m_mn_bins;
+                ar["timeseries/data"] = m_mn_bins.to_vector();
                 ar["timeseries/data/@binningtype"] = "linear";
                 ar["timeseries/data/@minbinsize"] = 0; // TODO: what should we put here?
                 ar["timeseries/data/@binsize"] = m_mn_elements_in_bin;
@@ -97,9 +110,11 @@ namespace alps {
             template<typename T, typename B>
             void Accumulator<T, max_num_binning_tag, B>::load(hdf5::archive & ar) { // TODO: make archive const
                 B::load(ar);
-                ar["timeseries/data"] >> m_mn_bins;
+                std::vector<typename mean_type<B>::type> bins;
+                ar["timeseries/data"] >> bins;
                 ar["timeseries/data/@binsize"] >> m_mn_elements_in_bin;
                 ar["timeseries/data/@maxbinnum"] >> m_mn_max_number;
+                m_mn_bins.assign(bins, m_mn_max_number + 1);
                 if (ar.is_data("timeseries/partialbin")) {
                     ar["timeseries/partialbin"] >> m_mn_partial;
                     ar["timeseries/partialbin/@count"] >> m_mn_elements_in_partial;
@@ -130,7 +145,7 @@ namespace alps {
                 m_mn_elements_in_bin = typename B::count_type();
                 m_mn_elements_in_partial = typename B::count_type();
                 m_mn_partial = T();
-                m_mn_bins = std::vector<typename mean_type<B>::type>();
+                m_mn_bins.clear();
             }
 
 #ifdef ALPS_HAVE_MPI
@@ -141,13 +156,14 @@ namespace alps {
                 if (comm.rank() == root) {
                     B::collective_merge(comm, root);
                     if (!m_mn_bins.empty()) {
-                        std::vector<typename mean_type<B>::type> local_bins(m_mn_bins), merged_bins;
+                        std::vector<typename mean_type<B>::type> local_bins(m_mn_bins.to_vector()), merged_bins, reduced_bins;
                         partition_bins(comm, local_bins, merged_bins, root);
                         B::reduce_if(comm,
                                       merged_bins,
-                                      m_mn_bins,
+                                      reduced_bins,
                                       std::plus<typename alps::hdf5::scalar_type<typename mean_type<B>::type>::type>(),
                                       root);
+                        m_mn_bins.assign(reduced_bins, m_mn_max_number + 1);
                     }
                 } else
                     const_cast<Accumulator<T, max_num_binning_tag, B> const *>(this)->collective_merge(comm, root);
@@ -161,7 +177,7 @@ namespace alps {
                 if (comm.rank() == root)
                     throw std::runtime_error("A const object cannot be root" + ALPS_STACKTRACE);
                 else if (!m_mn_bins.empty()) {
-                    std::vector<typename mean_type<B>::type> local_bins(m_mn_bins), merged_bins;
+                    std::vector<typename mean_type<B>::type> local_bins(m_mn_bins.to_vector()), merged_bins;
                     partition_bins(comm, local_bins, merged_bins, root);
                     B::reduce_if(comm, merged_bins, std::plus<typename alps::hdf5::scalar_type<typename mean_type<B>::type>::type>(), root);
                 }
@@ -173,27 +189,47 @@ namespace alps {
                                                                         std::vector<typename mean_type<B>::type> & merged_bins,
                                                                         int) const
             {
-                using alps::numeric::operator+;
-                using alps::numeric::operator/;
-                using alps::numeric::check_size;
-
                 typename B::count_type elements_in_local_bins = alps::mpi::all_reduce(comm, m_mn_elements_in_bin, alps::mpi::maximum<typename B::count_type>());
+                rebin_local_bins(local_bins, elements_in_local_bins);
+
+                std::vector<std::size_t> index(comm.size());
+                alps::mpi::all_gather(comm, local_bins.size(), index);
+                std::size_t total_bins = std::accumulate(index.begin(), index.end(), 0);
+                std::size_t start = std::accumulate(index.begin(), index.begin() + comm.rank(), 0);
+                spread_bins(local_bins, merged_bins, start, total_bins);
+            }
+
+            template<typename T, typename B>
+            void Accumulator<T, max_num_binning_tag, B>::rebin_local_bins(std::vector<typename mean_type<B>::type> & local_bins,
+                                                                          typename B::count_type elements_in_local_bins) const
+            {
+                using alps::numeric::operator+=;
+
                 typename B::count_type howmany = (elements_in_local_bins - 1) / m_mn_elements_in_bin + 1;
                 if (howmany > 1) {
                     typename B::count_type newbins = local_bins.size() / howmany;
-                    typename alps::numeric::scalar<typename mean_type<B>::type>::type howmany_vt = howmany;
+                    // howmany is a ratio of power-of-two bin sizes: the reciprocal is exact
+                    typename alps::numeric::scalar<typename mean_type<B>::type>::type inv_howmany = 1. / howmany;
                     for (typename B::count_type i = 0; i < newbins; ++i) {
-                        local_bins[i] = local_bins[howmany * i];
+                        if (i > 0) std::swap(local_bins[i], local_bins[howmany * i]);
                         for (typename B::count_type j = 1; j < howmany; ++j)
-                            local_bins[i] = local_bins[i] + local_bins[howmany * i + j];
-                        local_bins[i] = local_bins[i] / howmany_vt;
+                            local_bins[i] += local_bins[howmany * i + j];
+                        alps::numeric::scale_inplace(local_bins[i], inv_howmany);
                     }
                         local_bins.resize(newbins);
                 }
+            }
+
+            template<typename T, typename B>
+            void Accumulator<T, max_num_binning_tag, B>::spread_bins(std::vector<typename mean_type<B>::type> const & local_bins,
+                                                                     std::vector<typename mean_type<B>::type> & merged_bins,
+                                                                     std::size_t start,
+                                                                     std::size_t total_bins) const
+            {
+                using alps::numeric::operator+;
+                using alps::numeric::operator/;
+                using alps::numeric::check_size;
 
-                std::vector<std::size_t> index(comm.size());
-                alps::mpi::all_gather(comm, local_bins.size(), index);
-                std::size_t total_bins = std::accumulate(index.begin(), index.end(), 0);
                 std::size_t perbin = total_bins < m_mn_max_number ? 1 : total_bins / m_mn_max_number;
                 typename alps::numeric::scalar<typename mean_type<B>::type>::type perbin_vt = perbin;
 
@@ -201,13 +237,47 @@ namespace alps {
                 for (typename std::vector<typename mean_type<B>::type>::iterator it = merged_bins.begin(); it != merged_bins.end(); ++it)
                     check_size(*it, local_bins[0]);
 
-                std::size_t start = std::accumulate(index.begin(), index.begin() + comm.rank(), 0);
                 for (std::size_t i = start / perbin, j = start % perbin, k = 0; i < merged_bins.size() && k < local_bins.size(); ++k) {
                     merged_bins[i] = merged_bins[i] + local_bins[k] / perbin_vt;
                     if (++j == perbin)
                         ++i, j = 0;
                 }
             }
+
+            template<typename T, typename B>
+            void Accumulator<T, max_num_binning_tag, B>::collective_merge(alps::alps_mpi::merge_buffer & buffer) {
+                typedef alps::alps_mpi::merge_buffer merge_buffer;
+
+                B::collective_merge(buffer);
+                switch (buffer.phase()) {
+                    case merge_buffer::shape_phase:
+                        buffer.put_shape(m_mn_elements_in_bin);
+                        break;
+                    case merge_buffer::layout_phase: {
+                        // number of local bins after rebin_local_bins()
+                        typename B::count_type howmany = (buffer.get_shape() - 1) / m_mn_elements_in_bin + 1;
+                        buffer.put_layout(howmany > 1 ? m_mn_bins.size() / howmany : m_mn_bins.size());
+                        break;
+                    }
+                    case merge_buffer::pack_phase:
+                    case merge_buffer::unpack_phase: {
+                        typename B::count_type elements_in_local_bins = buffer.get_shape();
+                        std::pair<merge_buffer::size_type, merge_buffer::size_type> layout = buffer.get_layout();
+                        std::vector<typename mean_type<B>::type> local_bins(m_mn_bins.to_vector()), merged_bins;
+                        rebin_local_bins(local_bins, elements_in_local_bins);
+                        spread_bins(local_bins, merged_bins, layout.first, layout.second);
+                        if (buffer.phase() == merge_buffer::pack_phase)
+                            buffer.pack(merged_bins);
+                        else {
+                            buffer.unpack(merged_bins);
+                            m_mn_bins.assign(merged_bins, m_mn_max_number + 1);
+                        }
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            }
 #endif
 
             #define ALPS_ACCUMULATOR_INST_MAX_NUM_BINNING_ACC(r, data, T)                          \
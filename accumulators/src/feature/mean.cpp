@@ -42,6 +42,18 @@ namespace alps {
                 m_sum += val;
             }
 
+            template<typename T, typename B>
+            void Accumulator<T, mean_tag, B>::add_many(T const * data, std::size_t n) {
+                using alps::numeric::operator+=;
+                using alps::numeric::check_size;
+
+                B::add_many(data, n);
+                for (std::size_t j = 0; j < n; ++j) {
+                    check_size(m_sum, data[j]);
+                    m_sum += data[j];
+                }
+            }
+
             template<typename T, typename B>
             void Accumulator<T, mean_tag, B>::save(hdf5::archive & ar) const {
                 B::save(ar);
@@ -94,6 +106,12 @@ namespace alps {
                 else
                     B::reduce_if(comm, m_sum, std::plus<typename alps::hdf5::scalar_type<T>::type>(), root);
             }
+
+            template<typename T, typename B>
+            void Accumulator<T, mean_tag, B>::collective_merge(alps::alps_mpi::merge_buffer & buffer) {
+                B::collective_merge(buffer);
+                buffer.transfer(m_sum);
+            }
 #endif
 
             template<typename T, typename B>
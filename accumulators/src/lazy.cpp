@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#include <alps/accumulators/lazy.hpp>
+#include <alps/accumulators/namedaccumulators.hpp>
+#include <alps/numeric/special_functions.hpp>
+
+#include <cmath>
+#include <typeinfo>
+
+namespace alps {
+    namespace accumulators {
+
+        namespace detail {
+
+            /// Result type whose bins the expression is evaluated on
+            typedef FullBinningAccumulator<double>::result_type fused_result_type;
+
+            class expression_node {
+                public:
+                    virtual ~expression_node() {}
+
+                    /// Value of the expression for bin `i`, or jackknife bin `i`
+                    virtual double value(bool jackknife, std::size_t i) const = 0;
+
+                    /// Evaluate with the result_wrapper operators
+                    virtual result_wrapper eager() const = 0;
+
+                    /// Collect the results of the leaves; false if one of them cannot be fused
+                    virtual bool collect(std::vector<fused_result_type const *> & leaves) const = 0;
+
+                    /// True for constants, whose value is then stored in `value`
+                    virtual bool constant(long double & /*value*/) const { return false; }
+            };
+
+            class leaf_node : public expression_node {
+                public:
+                    leaf_node(result_wrapper const & res)
+                        : m_res(&res), m_raw(NULL)
+                    {
+                        try {
+                            m_raw = &res.extract<fused_result_type>();
+                        } catch (std::bad_cast const &) {}
+                    }
+
+                    double value(bool jackknife, std::size_t i) const {
+                        return jackknife ? m_raw->get_jackknife_bins()[i] : m_raw->get_bins()[i];
+                    }
+
+                    result_wrapper eager() const { return *m_res; }
+
+                    bool collect(std::vector<fused_result_type const *> & leaves) const {
+                        leaves.push_back(m_raw);
+                        return m_raw != NULL;
+                    }
+
+                private:
+                    result_wrapper const * m_res;
+                    fused_result_type const * m_raw;
+            };
+
+            class constant_node : public expression_node {
+                public:
+                    constant_node(long double value) : m_value(value) {}
+
+                    double value(bool /*jackknife*/, std::size_t /*i*/) const { return static_cast<double>(m_value); }
+
+                    result_wrapper eager() const {
+                        throw std::logic_error("A constant is not a result" + ALPS_STACKTRACE);
+                    }
+
+                    bool collect(std::vector<fused_result_type const *> & /*leaves*/) const { return true; }
+
+                    bool constant(long double & value) const { value = m_value; return true; }
+
+                private:
+                    long double m_value;
+            };
+
+            class unary_node : public expression_node {
+                public:
+                    typedef double (*value_function)(double);
+                    typedef result_wrapper (*eager_function)(result_wrapper const &);
+
+                    unary_node(value_function fv, eager_function fe, result_expression::node_ptr const & arg)
+                        : m_fv(fv), m_fe(fe), m_arg(arg)
+                    {}
+
+                    double value(bool jackknife, std::size_t i) const { return m_fv(m_arg->value(jackknife, i)); }
+
+                    result_wrapper eager() const { return m_fe(m_arg->eager()); }
+
+                    bool collect(std::vector<fused_result_type const *> & leaves) const { return m_arg->collect(leaves); }
+
+                private:
+                    value_function m_fv;
+                    eager_function m_fe;
+                    result_expression::node_ptr m_arg;
+            };
+
+            template<typename OP> class binary_node : public expression_node {
+                public:
+                    binary_node(result_expression::node_ptr const & lhs, result_expression::node_ptr const & rhs)
+                        : m_lhs(lhs), m_rhs(rhs)
+                    {}
+
+                    double value(bool jackknife, std::size_t i) const {
+                        return OP()(m_lhs->value(jackknife, i), m_rhs->value(jackknife, i));
+                    }
+
+                    result_wrapper eager() const {
+                        long double c;
+                        if (m_lhs->constant(c))
+                            return OP()(c, m_rhs->eager());
+                        if (m_rhs->constant(c))
+                            return OP()(m_lhs->eager(), c);
+                        return OP()(m_lhs->eager(), m_rhs->eager());
+                    }
+
+                    bool collect(std::vector<fused_result_type const *> & leaves) const {
+                        const bool lhs = m_lhs->collect(leaves);
+                        return m_rhs->collect(leaves) && lhs;
+                    }
+
+                private:
+                    result_expression::node_ptr m_lhs, m_rhs;
+            };
+
+            #define ALPS_ACCUMULATOR_EXPRESSION_OP(NAME, OP)                                              \
+                struct NAME {                                                                             \
+                    template<typename X, typename Y> auto operator()(X const & x, Y const & y) const      \
+                        -> decltype(x OP y) { return x OP y; }                                            \
+                };
+            ALPS_ACCUMULATOR_EXPRESSION_OP(add_op, +)
+            ALPS_ACCUMULATOR_EXPRESSION_OP(sub_op, -)
+            ALPS_ACCUMULATOR_EXPRESSION_OP(mul_op, *)
+            ALPS_ACCUMULATOR_EXPRESSION_OP(div_op, /)
+            #undef ALPS_ACCUMULATOR_EXPRESSION_OP
+
+            double negate_value(double x) { return -x; }
+            result_wrapper negate_result(result_wrapper const & x) { return -x; }
+        }
+
+        result_expression::result_expression(result_wrapper const & res)
+            : m_node(std::make_shared<detail::leaf_node>(res))
+        {}
+
+        result_wrapper result_expression::evaluate() const {
+            std::vector<detail::fused_result_type const *> leaves;
+            if (!m_node->collect(leaves))
+                return m_node->eager();
+
+            for (std::vector<detail::fused_result_type const *>::const_iterator it = leaves.begin(); it != leaves.end(); ++it) {
+                (*it)->generate_jackknife();
+                if ((*it)->get_jackknife_bins().size() != leaves.front()->get_jackknife_bins().size())
+                    throw std::runtime_error("Unable to transform: unequal number of bins" + ALPS_STACKTRACE);
+            }
+
+            // the only copy of the data: the result takes its bin sizes from the first leaf
+            result_wrapper res(static_cast<base_wrapper<double> *>(new derived_result_wrapper<detail::fused_result_type>(*leaves.front())));
+            detail::expression_node const & node = *m_node;
+            res.extract<detail::fused_result_type>().transform_bins(
+                [&node](std::vector<double> & bins, std::vector<double> & jackknife_bins) {
+                    for (std::size_t i = 0; i < bins.size(); ++i)
+                        bins[i] = node.value(false, i);
+                    for (std::size_t i = 0; i < jackknife_bins.size(); ++i)
+                        jackknife_bins[i] = node.value(true, i);
+                });
+            return res;
+        }
+
+        result_expression operator-(result_expression const & arg) {
+            return result_expression(std::make_shared<detail::unary_node>(&detail::negate_value, &detail::negate_result, arg.node()));
+        }
+
+        namespace {
+            result_expression::node_ptr constant(long double value) {
+                return std::make_shared<detail::constant_node>(value);
+            }
+        }
+
+        #define ALPS_ACCUMULATOR_EXPRESSION_OPERATOR(OPNAME, OP)                                              \
+            result_expression OPNAME (result_expression const & lhs, result_expression const & rhs) {         \
+                return result_expression(std::make_shared<detail::binary_node<detail:: OP > >(lhs.node(), rhs.node())); \
+            }                                                                                                 \
+            result_expression OPNAME (result_expression const & lhs, long double rhs) {                       \
+                return result_expression(std::make_shared<detail::binary_node<detail:: OP > >(lhs.node(), constant(rhs))); \
+            }                                                                                                 \
+            result_expression OPNAME (long double lhs, result_expression const & rhs) {                       \
+                return result_expression(std::make_shared<detail::binary_node<detail:: OP > >(constant(lhs), rhs.node())); \
+            }
+        ALPS_ACCUMULATOR_EXPRESSION_OPERATOR(operator+, add_op)
+        ALPS_ACCUMULATOR_EXPRESSION_OPERATOR(operator-, sub_op)
+        ALPS_ACCUMULATOR_EXPRESSION_OPERATOR(operator*, mul_op)
+        ALPS_ACCUMULATOR_EXPRESSION_OPERATOR(operator/, div_op)
+        #undef ALPS_ACCUMULATOR_EXPRESSION_OPERATOR
+
+        #define ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(FUN, VALUE_FUN)                                          \
+            namespace detail {                                                                                \
+                double FUN ## _value(double x) { return VALUE_FUN(x); }                                       \
+                result_wrapper FUN ## _result(result_wrapper const & x) { return x. FUN (); }                 \
+            }                                                                                                 \
+            result_expression FUN (result_expression const & arg) {                                           \
+                return result_expression(std::make_shared<detail::unary_node>(                                \
+                    &detail:: FUN ## _value, &detail:: FUN ## _result, arg.node()));                          \
+            }
+        ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(sin, std::sin)
+        ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(cos, std::cos)
+        ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(tan, std::tan)
+        ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(sinh, std::sinh)
+        ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(cosh, std::cosh)
+        ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(tanh, std::tanh)
+        ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(asin, std::asin)
+        ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(acos, std::acos)
+        ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(atan, std::atan)
+        ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(abs, std::abs)
+        ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(sqrt, std::sqrt)
+        ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(log, std::log)
+        ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(sq, alps::numeric::sq)
+        ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(cb, alps::numeric::cb)
+        ALPS_ACCUMULATOR_EXPRESSION_FUNCTION(cbrt, alps::numeric::cbrt)
+        #undef ALPS_ACCUMULATOR_EXPRESSION_FUNCTION
+    }
+}
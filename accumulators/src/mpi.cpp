@@ -268,6 +268,64 @@
             ALPS_INST_MPI_REDUCE(double)
             ALPS_INST_MPI_REDUCE(long double)
 
+            //
+            // merge_buffer
+            //
+
+            template<typename S> void merge_buffer::reduce_data(const communicator & comm, data_buffer<S> & buf, int root) {
+                if (buf.values.empty())
+                    return;
+                using alps::mpi::get_mpi_datatype;
+                if (comm.rank() == root) {
+                    std::vector<S> sum(buf.values.size());
+                    detail::checked_mpi_reduce(&buf.values.front(), &sum.front(), buf.values.size(), get_mpi_datatype(S()),
+                                               alps::mpi::is_mpi_op<std::plus<S>, S>::op(), root, comm);
+                    buf.values.swap(sum);
+                } else
+                    detail::checked_mpi_reduce(&buf.values.front(), NULL, buf.values.size(), get_mpi_datatype(S()),
+                                               alps::mpi::is_mpi_op<std::plus<S>, S>::op(), root, comm);
+                buf.pos = 0;
+            }
+
+            void merge_buffer::finish_phase(const communicator & comm, int root) {
+                switch (m_phase) {
+                    case shape_phase:
+                        if (!m_shape.empty()) {
+                            std::vector<size_type> local(m_shape);
+                            alps::mpi::all_reduce(comm, &local.front(), local.size(), &m_shape.front(), alps::mpi::maximum<size_type>());
+                        }
+                        m_phase = layout_phase;
+                        break;
+                    case layout_phase:
+                        if (!m_layout.empty()) {
+                            using alps::mpi::get_mpi_datatype;
+                            // MPI_Exscan() leaves the output of rank 0 undefined
+                            m_layout_offset.assign(m_layout.size(), 0);
+                            std::vector<size_type> offset(m_layout.size());
+                            MPI_Exscan(&m_layout.front(), &offset.front(), m_layout.size(), get_mpi_datatype(size_type()), MPI_SUM, comm);
+                            if (comm.rank() != 0)
+                                m_layout_offset.swap(offset);
+                            m_layout_total.resize(m_layout.size());
+                            alps::mpi::all_reduce(comm, &m_layout.front(), m_layout.size(), &m_layout_total.front(), std::plus<size_type>());
+                        }
+                        m_phase = pack_phase;
+                        break;
+                    case pack_phase:
+                        reduce_data(comm, m_counts, root);
+                        reduce_data(comm, m_floats, root);
+                        reduce_data(comm, m_doubles, root);
+                        reduce_data(comm, m_long_doubles, root);
+                        m_phase = comm.rank() == root ? unpack_phase : done_phase;
+                        break;
+                    case unpack_phase:
+                    case done_phase:
+                        m_phase = done_phase;
+                        break;
+                }
+                m_shape_pos = 0;
+                m_layout_pos = 0;
+            }
+
         } // alps_mpi::
     } // alps::
 
@@ -40,6 +40,18 @@ namespace alps {
             };
 
             void register_predefined_serializable_types();
+
+            /// Load into `existing` if it has the same type as `loaded`, so that handles to it stay valid
+            inline bool load_in_place(accumulator_wrapper & existing, accumulator_wrapper const & loaded, hdf5::archive & ar) {
+                if (!existing.has_same_type(loaded)) return false;
+                existing.reset();
+                existing.load(ar);
+                return true;
+            }
+            /// Results are always replaced
+            inline bool load_in_place(result_wrapper &, result_wrapper const &, hdf5::archive &) {
+                return false;
+            }
         }
 
         namespace impl {
@@ -95,17 +107,22 @@ namespace alps {
                 std::vector<std::string> list = ar.list_children("");
                 for (std::vector<std::string>::const_iterator it = list.begin(); it != list.end(); ++it) {
                     ar.set_context(*it);
+                    std::shared_ptr<T> loaded;
                     for (typename std::vector<std::shared_ptr<detail::serializable_type<T> > >::const_iterator jt = m_types.begin()
                         ; jt != m_types.end()
                         ; ++jt
                     )
                         if ((*jt)->can_load(ar)) {
-                            operator[](*it) = std::shared_ptr<T>((*jt)->create(ar));
+                            loaded.reset((*jt)->create(ar));
                             break;
                         }
-                    if (!has(*it))
+                    if (!loaded)
                         throw std::logic_error("The Accumulator/Result " + *it + " cannot be unserilized" + ALPS_STACKTRACE);
-                    operator[](*it).load(ar);
+                    // an existing accumulator of the same type is loaded in place, as handles may refer to it
+                    if (!has(*it) || !detail::load_in_place(operator[](*it), *loaded, ar)) {
+                        operator[](*it) = loaded;
+                        operator[](*it).load(ar);
+                    }
                     ar.set_context("..");
                 }
             }
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file add_many.cpp
+    Test that adding blocks of values gives bit-identical results to adding them one by one
+*/
+
+#include <alps/accumulators.hpp>
+#include <gtest/gtest.h>
+
+#include "accumulator_generator.hpp"
+
+namespace aa=alps::accumulators;
+
+template <typename T> struct value_gen;
+
+template <> struct value_gen<double> {
+    static double get(aa::testing::RandomData& gen) { return gen(); }
+};
+
+template <> struct value_gen< std::vector<double> > {
+    static std::vector<double> get(aa::testing::RandomData& gen) {
+        std::vector<double> v(3);
+        for (std::size_t i=0; i<v.size(); ++i) v[i]=gen();
+        return v;
+    }
+};
+
+template <typename A>
+class AddManyTest : public ::testing::Test {
+    public:
+    typedef typename A::accumulator_type raw_type;
+    typedef typename aa::value_type<raw_type>::type value_type;
+
+    aa::accumulator_set m;
+    std::vector<value_type> data;
+
+    AddManyTest() {
+        m << A("single") << A("block");
+        aa::testing::RandomData gen;
+        for (int i=0; i<5000; ++i) data.push_back(value_gen<value_type>::get(gen));
+    }
+
+    void feed_single() {
+        for (std::size_t i=0; i<data.size(); ++i) m["single"] << data[i];
+    }
+
+    // Blocks of varying size, including empty ones
+    template <typename F>
+    void feed_blocks(F add_block) {
+        std::size_t pos=0, len=0;
+        while (pos<data.size()) {
+            len=std::min((len*7+3)%41, data.size()-pos);
+            add_block(&data[pos], len);
+            pos+=len;
+        }
+    }
+
+    static void compare_binning(raw_type const&, raw_type const&, std::false_type) {}
+    static void compare_binning(raw_type const& single, raw_type const& block, std::true_type) {
+        EXPECT_EQ(single.autocorrelation(), block.autocorrelation());
+        for (std::size_t i=0; i<single.binning_depth(); ++i)
+            EXPECT_EQ(single.error(i), block.error(i)) << "binning level " << i;
+    }
+
+    static void compare_bins(raw_type const&, raw_type const&, std::false_type) {}
+    static void compare_bins(raw_type const& single, raw_type const& block, std::true_type) {
+        EXPECT_EQ(single.max_num_binning().num_elements(), block.max_num_binning().num_elements());
+        EXPECT_EQ(single.max_num_binning().bins(), block.max_num_binning().bins());
+    }
+
+    void compare() {
+        const raw_type& single=m["single"].extract<raw_type>();
+        const raw_type& block=m["block"].extract<raw_type>();
+        EXPECT_EQ(single.count(), block.count());
+        EXPECT_EQ(single.mean(), block.mean());
+        compare_binning(single, block, typename aa::has_feature<raw_type, aa::binning_analysis_tag>::type());
+        compare_bins(single, block, typename aa::has_feature<raw_type, aa::max_num_binning_tag>::type());
+    }
+};
+
+typedef ::testing::Types<
+    aa::MeanAccumulator<double>,
+    aa::NoBinningAccumulator<double>,
+    aa::LogBinningAccumulator<double>,
+    aa::FullBinningAccumulator<double>,
+    aa::MeanAccumulator< std::vector<double> >,
+    aa::NoBinningAccumulator< std::vector<double> >,
+    aa::LogBinningAccumulator< std::vector<double> >,
+    aa::FullBinningAccumulator< std::vector<double> >
+    > test_types;
+
+TYPED_TEST_CASE(AddManyTest, test_types);
+
+TYPED_TEST(AddManyTest, Wrapper) {
+    typedef typename TestFixture::value_type value_type;
+    this->feed_single();
+    aa::accumulator_wrapper& block=this->m["block"];
+    this->feed_blocks([&block](value_type const* p, std::size_t n) { block.add_many(p, n); });
+    this->compare();
+}
+
+TYPED_TEST(AddManyTest, Handle) {
+    typedef typename TestFixture::value_type value_type;
+    this->feed_single();
+    aa::accumulator_handle<TypeParam> h=this->m.template handle<TypeParam>("block");
+    this->feed_blocks([&h](value_type const* p, std::size_t n) { h.add_many(p, n); });
+    this->compare();
+}
+
+TYPED_TEST(AddManyTest, WholeVector) {
+    this->feed_single();
+    this->m["block"].add_many(this->data);
+    this->compare();
+}
+
+TEST(AddManyTest, Errors) {
+    aa::accumulator_set m;
+    m << aa::MeanAccumulator<double>("scalar") << aa::MeanAccumulator< std::vector<double> >("vector");
+
+    const float fdata[]={ 1., 2. };
+    EXPECT_THROW(m["scalar"].add_many(fdata, 2), std::logic_error);
+
+    std::vector< std::vector<double> > vdata(2, std::vector<double>(3, 1.));
+    vdata[1].clear();
+    EXPECT_THROW(m["vector"].add_many(vdata), std::runtime_error);
+
+    const double ddata[]={ 1., 2. };
+    m["scalar"].add_many(ddata, 2);
+    aa::result_set res(m);
+    EXPECT_THROW(res["scalar"].get<double>().add_many(ddata, 2), std::runtime_error);
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file alloc_free.cpp
+    Test that, once warmed up, accumulators of vectors do not allocate per sample
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include <alps/accumulators.hpp>
+#include <alps/testing/unique_file.hpp>
+#include <gtest/gtest.h>
+
+// Count all heap allocations in this executable
+static std::size_t allocation_count=0;
+
+void* operator new(std::size_t sz) {
+    ++allocation_count;
+    if (void* p=std::malloc(sz ? sz : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace aa=alps::accumulators;
+
+template <typename A>
+class AllocFreeTest : public ::testing::Test {
+    public:
+    aa::accumulator_set m;
+
+    AllocFreeTest() { m << A("obs"); }
+};
+
+typedef std::vector<double> dvec;
+
+typedef ::testing::Types<
+    aa::MeanAccumulator<dvec>,
+    aa::NoBinningAccumulator<dvec>,
+    aa::LogBinningAccumulator<dvec>,
+    aa::FullBinningAccumulator<dvec>
+    > test_types;
+
+TYPED_TEST_CASE(AllocFreeTest, test_types);
+
+TYPED_TEST(AllocFreeTest, NoAllocationPerSample) {
+    const std::string name="obs";
+    dvec v(10);
+    // Warm up: 2^12+1 samples, so that no new binning level is created below 2^13
+    std::size_t i=0;
+    for (; i<4097; ++i) {
+        v[i%v.size()]=0.5*i;
+        this->m[name] << v;
+    }
+    aa::accumulator_wrapper& acc=this->m[name];
+
+    const std::size_t before=allocation_count;
+    for (; i<8191; ++i) {
+        v[i%v.size()]=0.5*i;
+        acc << v;
+    }
+    EXPECT_EQ(before, allocation_count);
+}
+
+// After a checkpoint reload the full-binning bins must still have room for all bins
+TEST(AllocFree, FullBinningAfterLoad) {
+    typedef aa::FullBinningAccumulator<dvec> acc_type;
+    const std::string fname=alps::testing::temporary_filename("alloc_free.h5.");
+    dvec v(10);
+    std::size_t i=0;
+    {
+        aa::accumulator_set m;
+        m << acc_type("obs");
+        for (; i<4097; ++i) {
+            v[i%v.size()]=0.5*i;
+            m["obs"] << v;
+        }
+        alps::hdf5::archive ar(fname, "w");
+        ar["set"] << m;
+    }
+    aa::accumulator_set m2;
+    {
+        alps::hdf5::archive ar(fname, "r");
+        ar["set"] >> m2;
+    }
+    std::remove(fname.c_str());
+    aa::accumulator_wrapper& acc=m2["obs"];
+    ASSERT_EQ(4097u, acc.count());
+
+    const std::size_t before=allocation_count;
+    for (; i<8191; ++i) {
+        v[i%v.size()]=0.5*i;
+        acc << v;
+    }
+    EXPECT_EQ(before, allocation_count);
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file binning_levels.cpp
+    Test the binning levels of binning-analysis accumulators against the straightforward per-level update
+*/
+
+#include <chrono>
+#include <iostream>
+
+#include <alps/accumulators.hpp>
+#include <alps/testing/unique_file.hpp>
+#include <gtest/gtest.h>
+
+namespace aa=alps::accumulators;
+
+typedef std::vector<double> dvec;
+
+/// Reference binning analysis: every sample is added to the partial bin of every level
+class reference_levels {
+  public:
+    reference_levels() : count_(0) {}
+
+    void add(dvec const& val) {
+        using alps::numeric::operator+=;
+        using alps::numeric::operator*;
+        ++count_;
+        if (count_==(1ul << sum2_.size())) {
+            sum2_.push_back(dvec(val.size()));
+            sum_.push_back(dvec(val.size()));
+            partial_.push_back(sum_[0]);
+            counts_.push_back(0);
+        }
+        for (std::size_t i=0; i<sum2_.size(); ++i) {
+            partial_[i] += val;
+            if (!(count_ & ((1ul << i)-1))) {
+                sum2_[i] += partial_[i]*partial_[i];
+                sum_[i] += partial_[i];
+                ++counts_[i];
+                partial_[i]=dvec(val.size());
+            }
+        }
+    }
+
+    std::vector<dvec> const& sum() const { return sum_; }
+    std::vector<dvec> const& sum2() const { return sum2_; }
+    std::vector<dvec> const& partial() const { return partial_; }
+    std::vector<unsigned long> const& counts() const { return counts_; }
+
+  private:
+    unsigned long count_;
+    std::vector<dvec> sum_, sum2_, partial_;
+    std::vector<unsigned long> counts_;
+};
+
+class BinningLevelsTest : public ::testing::TestWithParam<std::size_t> {
+  public:
+    typedef aa::LogBinningAccumulator<dvec> named_acc_type;
+
+    aa::accumulator_set m;
+    reference_levels ref;
+    std::size_t nsamples;
+
+    BinningLevelsTest() : nsamples(0) {
+        m << named_acc_type("obs");
+    }
+
+    // small integers: all sums are exact, so the summation order does not matter
+    void fill(aa::accumulator_set& set, std::size_t n) {
+        for (std::size_t i=0; i<n; ++i, ++nsamples) {
+            dvec v(3);
+            for (std::size_t k=0; k<v.size(); ++k) v[k]=double((nsamples*(k+3))%11);
+            set["obs"] << v;
+            ref.add(v);
+        }
+    }
+
+    void check_levels(aa::accumulator_set const& set) {
+        alps::testing::unique_file ufile("binning_levels.h5.", alps::testing::unique_file::REMOVE_AFTER);
+        {
+            alps::hdf5::archive ar(ufile.name(), "w");
+            ar["set"] << set;
+        }
+        alps::hdf5::archive ar(ufile.name(), "r");
+        std::vector<dvec> sum, sum2, partial;
+        std::vector<unsigned long> counts;
+        ar["set/obs/tau/partialbin"] >> sum;
+        ar["set/obs/tau/data"] >> sum2;
+        ar["set/obs/tau/ac_partial"] >> partial;
+        ar["set/obs/tau/ac_count"] >> counts;
+        EXPECT_EQ(ref.sum(), sum);
+        EXPECT_EQ(ref.sum2(), sum2);
+        EXPECT_EQ(ref.partial(), partial);
+        EXPECT_EQ(ref.counts(), counts);
+    }
+};
+
+TEST_P(BinningLevelsTest, SameAsReference) {
+    fill(m, GetParam());
+    check_levels(m);
+}
+
+TEST_P(BinningLevelsTest, SaveLoad) {
+    fill(m, GetParam());
+    alps::testing::unique_file ufile("binning_levels_restart.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    {
+        alps::hdf5::archive ar(ufile.name(), "w");
+        ar["set"] << m;
+    }
+    aa::accumulator_set m2;
+    {
+        alps::hdf5::archive ar(ufile.name(), "r");
+        ar["set"] >> m2;
+    }
+    fill(m2, GetParam()+37);
+    check_levels(m2);
+}
+
+INSTANTIATE_TEST_CASE_P(Samples, BinningLevelsTest, ::testing::Values(1, 2, 3, 7, 64, 100, 1023, 4096, 5000));
+
+/// Micro-benchmark: run with --gtest_also_run_disabled_tests
+TEST(BinningLevels, DISABLED_Benchmark) {
+    typedef std::chrono::steady_clock clock_type;
+    typedef std::chrono::duration<double, std::nano> ns;
+    const std::size_t size=1000, nsamples=1 << 16;
+    dvec v(size, 0.5);
+
+    aa::accumulator_set m;
+    m << aa::LogBinningAccumulator<dvec>("obs");
+    aa::accumulator_set mean_only;
+    mean_only << aa::NoBinningAccumulator<dvec>("obs");
+    reference_levels ref;
+
+    clock_type::time_point t0=clock_type::now();
+    for (std::size_t i=0; i<nsamples; ++i) m["obs"] << v;
+    clock_type::time_point t1=clock_type::now();
+    for (std::size_t i=0; i<nsamples; ++i) mean_only["obs"] << v;
+    clock_type::time_point t2=clock_type::now();
+    for (std::size_t i=0; i<nsamples; ++i) ref.add(v);
+    clock_type::time_point t3=clock_type::now();
+
+    std::cout << "ns/sample of " << size << " elements: LogBinning " << ns(t1-t0).count()/nsamples
+              << ", NoBinning " << ns(t2-t1).count()/nsamples
+              << ", per-level reference levels only " << ns(t3-t2).count()/nsamples
+              << std::endl;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file full_binning_bins.cpp
+    Test the bins of full-binning accumulators against a straightforward reference binning
+*/
+
+#include <cstdio>
+
+#include <alps/accumulators.hpp>
+#include <gtest/gtest.h>
+
+#include "accumulator_generator.hpp"
+
+namespace aa=alps::accumulators;
+
+typedef std::vector<double> dvec;
+
+/// Reference linear binning with a maximum number of bins, one vector per bin
+class reference_binning {
+  public:
+    explicit reference_binning(std::size_t maxbins) : maxbins_(maxbins), in_bin_(0), in_partial_(0) {}
+
+    void add(dvec const& val) {
+        using alps::numeric::operator+=;
+        using alps::numeric::operator+;
+        using alps::numeric::operator*;
+        using alps::numeric::operator/;
+        if (!in_bin_) {
+            bins_.push_back(val);
+            in_bin_=1;
+        } else {
+            if (partial_.empty()) partial_.resize(val.size());
+            partial_ += val;
+            ++in_partial_;
+        }
+        if (in_partial_==in_bin_ && bins_.size()>=maxbins_) {
+            if (maxbins_%2==1) {
+                partial_ += bins_[maxbins_-1]*double(in_bin_);
+                in_partial_ += in_bin_;
+            }
+            for (std::size_t i=0; i<maxbins_/2; ++i)
+                bins_[i]=(bins_[2*i]+bins_[2*i+1])/2.;
+            bins_.erase(bins_.begin()+maxbins_/2, bins_.end());
+            in_bin_*=2;
+        }
+        if (in_partial_==in_bin_) {
+            bins_.push_back(partial_/double(in_partial_));
+            partial_=dvec();
+            in_partial_=0;
+        }
+    }
+
+    std::vector<dvec> const& bins() const { return bins_; }
+    std::size_t elements_in_bin() const { return in_bin_; }
+
+  private:
+    std::size_t maxbins_, in_bin_, in_partial_;
+    dvec partial_;
+    std::vector<dvec> bins_;
+};
+
+class FullBinningBinsTest : public ::testing::TestWithParam<std::size_t> {
+  public:
+    typedef aa::FullBinningAccumulator<dvec> named_acc_type;
+    typedef named_acc_type::accumulator_type raw_acc_type;
+
+    aa::accumulator_set m;
+    reference_binning ref;
+
+    FullBinningBinsTest() : ref(GetParam()) {
+        m << named_acc_type("obs", GetParam());
+    }
+
+    void fill(std::size_t n) {
+        aa::testing::RandomData gen;
+        for (std::size_t i=0; i<n; ++i) {
+            dvec v(5);
+            for (std::size_t k=0; k<v.size(); ++k) v[k]=gen();
+            m["obs"] << v;
+            ref.add(v);
+        }
+    }
+};
+
+TEST_P(FullBinningBinsTest, SameAsReference) {
+    for (std::size_t n=1; n<3000; n=n*3+1) {
+        fill(n);
+        aa::max_num_binning_type<raw_acc_type>::type mnb=m["obs"].extract<raw_acc_type>().max_num_binning();
+        EXPECT_EQ(ref.elements_in_bin(), mnb.num_elements());
+        EXPECT_EQ(ref.bins(), mnb.bins());
+    }
+}
+
+TEST_P(FullBinningBinsTest, SaveLoad) {
+    fill(1000);
+    const std::string fname="full_binning_bins.h5";
+    std::remove(fname.c_str());
+    {
+        alps::hdf5::archive ar(fname, "w");
+        ar["set"] << m;
+        std::vector<std::size_t> extent=ar.extent("set/obs/timeseries/data");
+        ASSERT_EQ(2u, extent.size());
+        EXPECT_EQ(ref.bins().size(), extent[0]);
+        EXPECT_EQ(5u, extent[1]);
+    }
+    aa::accumulator_set m2;
+    {
+        alps::hdf5::archive ar(fname, "r");
+        ar["set"] >> m2;
+    }
+    std::remove(fname.c_str());
+
+    dvec v(5, 0.25);
+    for (int i=0; i<1000; ++i) m["obs"] << v;
+    for (int i=0; i<1000; ++i) m2["obs"] << v;
+    EXPECT_EQ(m["obs"].extract<raw_acc_type>().max_num_binning().bins(),
+              m2["obs"].extract<raw_acc_type>().max_num_binning().bins());
+}
+
+TEST_P(FullBinningBinsTest, SizeMismatch) {
+    fill(10);
+    EXPECT_THROW(m["obs"] << dvec(4, 1.), std::runtime_error);
+}
+
+/// Bins must be the means of consecutive blocks of samples, also when an odd maximum folds the last bin
+TEST_P(FullBinningBinsTest, BlockMeans) {
+    typedef aa::FullBinningAccumulator<double> scalar_acc_type;
+    m << scalar_acc_type("scalar", GetParam());
+    // small integers: all sums and power-of-two divisions are exact
+    std::vector<double> samples;
+    for (std::size_t i=0; i<2000; ++i) {
+        samples.push_back(double((i*7)%13));
+        m["scalar"] << samples.back();
+        m["obs"] << dvec(3, samples.back());
+
+        aa::max_num_binning_type<scalar_acc_type::accumulator_type>::type scalar_mnb=
+            m["scalar"].extract<scalar_acc_type::accumulator_type>().max_num_binning();
+        aa::max_num_binning_type<raw_acc_type>::type vector_mnb=m["obs"].extract<raw_acc_type>().max_num_binning();
+        const std::size_t n=scalar_mnb.num_elements();
+        ASSERT_EQ(n, vector_mnb.num_elements());
+        ASSERT_EQ(scalar_mnb.bins().size(), vector_mnb.bins().size());
+        for (std::size_t b=0; b<scalar_mnb.bins().size(); ++b) {
+            double sum=0;
+            for (std::size_t k=b*n; k<(b+1)*n; ++k) sum+=samples[k];
+            ASSERT_EQ(sum/n, scalar_mnb.bins()[b]) << "sample " << i << ", bin " << b;
+            ASSERT_EQ(dvec(3, sum/n), vector_mnb.bins()[b]) << "sample " << i << ", bin " << b;
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(MaxBinNumber, FullBinningBinsTest, ::testing::Values(3, 16, 17, 128));
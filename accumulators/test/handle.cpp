@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file handle.cpp
+    Test typed accumulator handles
+*/
+
+#include <alps/accumulators.hpp>
+#include <alps/testing/unique_file.hpp>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+namespace aa=alps::accumulators;
+
+template <typename A>
+class AccumulatorHandleTest : public ::testing::Test {
+    public:
+    typedef A named_acc_type;
+    typedef typename aa::value_type<typename A::accumulator_type>::type value_type;
+
+    aa::accumulator_set via_name;
+    aa::accumulator_set via_handle;
+
+    AccumulatorHandleTest() {
+        via_name << A("obs");
+        via_handle << A("obs");
+    }
+
+    // Generates the same deterministic sequence for both sets
+    static double sample(int i) { return 0.5*((i*7919)%101) - 3.; }
+
+    void check_same() {
+        aa::result_set r1(via_name), r2(via_handle);
+        EXPECT_EQ(r1["obs"].count(), r2["obs"].count());
+        EXPECT_EQ(r1["obs"].template mean<value_type>(), r2["obs"].template mean<value_type>());
+    }
+};
+
+typedef ::testing::Types<
+    aa::MeanAccumulator<double>,
+    aa::NoBinningAccumulator<double>,
+    aa::LogBinningAccumulator<double>,
+    aa::FullBinningAccumulator<double>
+    > test_types;
+
+TYPED_TEST_CASE(AccumulatorHandleTest, test_types);
+
+TYPED_TEST(AccumulatorHandleTest, ValueTypeHandle) {
+    aa::accumulator_handle<double> h=this->via_handle.template handle<double>("obs");
+    for (int i=0; i<1000; ++i) {
+        this->via_name["obs"] << this->sample(i);
+        h << this->sample(i);
+    }
+    this->check_same();
+}
+
+TYPED_TEST(AccumulatorHandleTest, NamedTypeHandle) {
+    typedef typename TestFixture::named_acc_type named_acc_type;
+    aa::accumulator_handle<named_acc_type> h=this->via_handle.template handle<named_acc_type>("obs");
+    for (int i=0; i<1000; ++i) {
+        this->via_name["obs"] << this->sample(i);
+        h << this->sample(i);
+    }
+    EXPECT_EQ(1000u, h.accumulator().count());
+    this->check_same();
+}
+
+// Checkpoint restart: handles made before load() must feed the loaded accumulator
+TYPED_TEST(AccumulatorHandleTest, LoadKeepsHandle) {
+    typedef typename TestFixture::value_type value_type;
+    const std::string fname=alps::testing::temporary_filename("handle_load.h5.");
+    for (int i=0; i<500; ++i) {
+        this->via_name["obs"] << this->sample(i);
+    }
+    {
+        alps::hdf5::archive ar(fname, "w");
+        ar["set"] << this->via_name;
+    }
+    aa::accumulator_handle<value_type> h=this->via_handle.template handle<value_type>("obs");
+    {
+        alps::hdf5::archive ar(fname, "r");
+        ar["set"] >> this->via_handle;
+    }
+    std::remove(fname.c_str());
+    EXPECT_EQ(500u, this->via_handle["obs"].count());
+
+    for (int i=500; i<1000; ++i) {
+        this->via_name["obs"] << this->sample(i);
+        h << this->sample(i);
+    }
+    EXPECT_EQ(1000u, this->via_handle["obs"].count());
+    this->check_same();
+}
+
+TEST(AccumulatorHandle, RawTypeHandle) {
+    typedef aa::FullBinningAccumulator<double>::accumulator_type raw_type;
+    aa::accumulator_set m;
+    m << aa::FullBinningAccumulator<double>("obs");
+    aa::accumulator_handle<raw_type> h=m.handle<raw_type>("obs");
+    h << 1. << 2. << 3.;
+    EXPECT_EQ(3u, m["obs"].count());
+    EXPECT_EQ(2., m["obs"].mean<double>());
+}
+
+TEST(AccumulatorHandle, VectorHandle) {
+    typedef std::vector<double> dvec;
+    aa::accumulator_set m;
+    m << aa::NoBinningAccumulator<dvec>("obs");
+    aa::accumulator_handle<dvec> h=m.handle<dvec>("obs");
+    h << dvec(3, 1.) << dvec(3, 3.);
+    EXPECT_EQ(dvec(3, 2.), m["obs"].mean<dvec>());
+    EXPECT_THROW(h << dvec(), std::runtime_error);
+}
+
+TEST(AccumulatorHandle, OutlivesSet) {
+    aa::accumulator_handle<double> h=[]() {
+        aa::accumulator_set m;
+        m << aa::MeanAccumulator<double>("obs");
+        return m.handle<double>("obs");
+    }();
+    h << 1.;
+}
+
+TEST(AccumulatorHandle, Mismatch) {
+    aa::accumulator_set m;
+    m << aa::MeanAccumulator<double>("obs");
+    EXPECT_THROW(m.handle<double>("nonexistent"), std::out_of_range);
+    EXPECT_THROW(m.handle<float>("obs"), std::runtime_error);
+    EXPECT_THROW(m.handle< aa::NoBinningAccumulator<double> >("obs"), std::bad_cast);
+}
+
+/// Micro-benchmark: run with --gtest_also_run_disabled_tests
+TEST(AccumulatorHandle, DISABLED_Benchmark) {
+    typedef std::chrono::steady_clock clock_type;
+    const char* names[]={ "E", "M", "M2", "M4", "C" };
+    const int nobs=sizeof(names)/sizeof(*names);
+    const long nsweeps=2000000;
+
+    aa::accumulator_set m1, m2, m3;
+    for (int i=0; i<nobs; ++i) {
+        m1 << aa::FullBinningAccumulator<double>(names[i]);
+        m2 << aa::FullBinningAccumulator<double>(names[i]);
+        m3 << aa::FullBinningAccumulator<double>(names[i]);
+    }
+    std::vector< aa::accumulator_handle<double> > h2;
+    std::vector< aa::accumulator_handle< aa::FullBinningAccumulator<double> > > h3;
+    for (int i=0; i<nobs; ++i) {
+        h2.push_back(m2.handle<double>(names[i]));
+        h3.push_back(m3.handle< aa::FullBinningAccumulator<double> >(names[i]));
+    }
+
+    clock_type::time_point t0=clock_type::now();
+    for (long s=0; s<nsweeps; ++s)
+        for (int i=0; i<nobs; ++i) m1[names[i]] << double(s+i);
+    clock_type::time_point t1=clock_type::now();
+    for (long s=0; s<nsweeps; ++s)
+        for (int i=0; i<nobs; ++i) h2[i] << double(s+i);
+    clock_type::time_point t2=clock_type::now();
+    for (long s=0; s<nsweeps; ++s)
+        for (int i=0; i<nobs; ++i) h3[i] << double(s+i);
+    clock_type::time_point t3=clock_type::now();
+
+    const double nsamples=double(nsweeps)*nobs;
+    typedef std::chrono::duration<double, std::nano> ns;
+    std::cout << "ns/sample: by name " << ns(t1-t0).count()/nsamples
+              << ", value-type handle " << ns(t2-t1).count()/nsamples
+              << ", named-type handle " << ns(t3-t2).count()/nsamples
+              << std::endl;
+
+    EXPECT_EQ(m1["E"].count(), m3["E"].count());
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file lazy_expression.cpp
+    Test deferred result arithmetic against the result_wrapper operators
+*/
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#include <alps/accumulators.hpp>
+#include <alps/accumulators/lazy.hpp>
+#include <gtest/gtest.h>
+
+namespace aa=alps::accumulators;
+
+class LazyExpressionTest : public ::testing::Test {
+  public:
+    aa::accumulator_set m;
+    aa::result_set results;
+
+    LazyExpressionTest() : results(fill(m)) {}
+
+    static aa::accumulator_set & fill(aa::accumulator_set & m) {
+        m << aa::FullBinningAccumulator<double>("a")
+          << aa::FullBinningAccumulator<double>("b")
+          << aa::NoBinningAccumulator<double>("c")
+          << aa::FullBinningAccumulator<double>("short");
+        for (int i=0; i<10000; ++i) {
+            const double x=0.5+0.25*std::sin(0.1*i);
+            m["a"] << x;
+            m["b"] << x*x+0.1*std::cos(0.37*i);
+            m["c"] << x;
+            if (i<1000) m["short"] << x;
+        }
+        return m;
+    }
+
+    static void expect_same(aa::result_wrapper const & expected, aa::result_wrapper const & actual) {
+        EXPECT_EQ(expected.count(), actual.count());
+        EXPECT_NEAR(expected.mean<double>(), actual.mean<double>(), 1E-12*std::abs(expected.mean<double>()));
+        EXPECT_NEAR(expected.error<double>(), actual.error<double>(), 1E-10*expected.error<double>());
+    }
+};
+
+TEST_F(LazyExpressionTest, BinderCumulant) {
+    const aa::result_wrapper& a=results["a"];
+    const aa::result_wrapper& b=results["b"];
+    aa::result_wrapper eager=1-a/(3*b*b);
+    aa::result_expression la=aa::lazy(a), lb=aa::lazy(b);
+    aa::result_wrapper lazy=(1-la/(3*lb*lb)).evaluate();
+    // the same operations on every bin in the same order
+    EXPECT_EQ(eager.mean<double>(), lazy.mean<double>());
+    EXPECT_EQ(eager.error<double>(), lazy.error<double>());
+    EXPECT_EQ(eager.count(), lazy.count());
+}
+
+TEST_F(LazyExpressionTest, Functions) {
+    const aa::result_wrapper& a=results["a"];
+    const aa::result_wrapper& b=results["b"];
+    aa::result_expression la=aa::lazy(a), lb=aa::lazy(b);
+    expect_same(aa::sqrt(aa::sin(a))+aa::cb(b)-a*b/2, (aa::sqrt(aa::sin(la))+aa::cb(lb)-la*lb/2).evaluate());
+    expect_same(aa::log(a)*aa::sq(b), (aa::log(la)*aa::sq(lb)).evaluate());
+    expect_same(-aa::atan(a)+aa::cosh(b), (-aa::atan(la)+aa::cosh(lb)).evaluate());
+    expect_same(2.5/a, (2.5/la).evaluate());
+    expect_same(a-0.5, (la-0.5).evaluate());
+}
+
+TEST_F(LazyExpressionTest, OperandsUnchanged) {
+    const aa::result_wrapper& a=results["a"];
+    const double mean=a.mean<double>(), error=a.error<double>();
+    aa::result_expression la=aa::lazy(a);
+    aa::result_wrapper res=(la*la+aa::sin(la)).evaluate();
+    EXPECT_EQ(mean, a.mean<double>());
+    EXPECT_EQ(error, a.error<double>());
+    // further arithmetic on the evaluated result still works
+    expect_same((a*a+aa::sin(a))*2, res*2);
+}
+
+TEST_F(LazyExpressionTest, Fallback) {
+    // results without jackknife bins are evaluated with the result_wrapper operators
+    const aa::result_wrapper& c=results["c"];
+    aa::result_expression lc=aa::lazy(c);
+    aa::result_wrapper res=(lc*2+aa::sq(lc)).evaluate();
+    EXPECT_EQ((c*2+aa::sq(c)).mean<double>(), res.mean<double>());
+    EXPECT_EQ((c*2+aa::sq(c)).error<double>(), res.error<double>());
+}
+
+TEST_F(LazyExpressionTest, UnequalBins) {
+    const aa::result_wrapper& a=results["a"];
+    const aa::result_wrapper& s=results["short"];
+    EXPECT_THROW(a/s, std::runtime_error);
+    EXPECT_THROW((aa::lazy(a)/aa::lazy(s)).evaluate(), std::runtime_error);
+}
+
+/// Micro-benchmark: run with --gtest_also_run_disabled_tests
+TEST(LazyExpression, DISABLED_Benchmark) {
+    typedef std::chrono::steady_clock clock_type;
+    typedef std::chrono::duration<double, std::micro> us;
+    const int nobs=32;
+
+    aa::accumulator_set m;
+    for (int k=0; k<nobs; ++k) {
+        std::ostringstream name;
+        name << "obs" << k;
+        m << aa::FullBinningAccumulator<double>(name.str());
+    }
+    for (int i=0; i<1<<16; ++i) {
+        for (int k=0; k<nobs; ++k) {
+            std::ostringstream name;
+            name << "obs" << k;
+            m[name.str()] << 1.+0.1*std::sin(0.01*i*(k+1));
+        }
+    }
+    aa::result_set results(m);
+    std::vector<aa::result_wrapper const*> obs;
+    for (aa::result_set::const_iterator it=results.begin(); it!=results.end(); ++it)
+        obs.push_back(&*it->second);
+
+    // sum of ratios of neighbouring observables
+    clock_type::time_point t0=clock_type::now();
+    aa::result_wrapper eager=*obs[0];
+    for (int k=1; k<nobs; ++k) eager=eager+*obs[k]/(*obs[k-1]*2);
+    const double eager_mean=eager.mean<double>();
+    clock_type::time_point t1=clock_type::now();
+    aa::result_expression expr=aa::lazy(*obs[0]);
+    for (int k=1; k<nobs; ++k) expr=expr+aa::lazy(*obs[k])/(aa::lazy(*obs[k-1])*2);
+    const double lazy_mean=expr.evaluate().mean<double>();
+    clock_type::time_point t2=clock_type::now();
+
+    EXPECT_NEAR(eager_mean, lazy_mean, 1E-12*eager_mean);
+    std::cout << "us for " << 3*(nobs-1) << " operations: eager " << us(t1-t0).count()
+              << ", lazy " << us(t2-t1).count() << std::endl;
+}
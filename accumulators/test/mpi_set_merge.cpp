@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file mpi_set_merge.cpp
+    Test that merging a whole set of accumulators gives the same results as merging them one by one
+*/
+
+#include <cmath>
+
+#include "alps/accumulators.hpp"
+
+#include "alps/utilities/gtest_par_xml_output.hpp"
+#include "gtest/gtest.h"
+
+#include "accumulator_generator.hpp"
+
+namespace aa=alps::accumulators;
+
+typedef std::vector<double> dvec;
+typedef std::vector<float> fvec;
+
+template <typename T> struct value_gen;
+
+template <> struct value_gen<double> {
+    static double get(double x) { return x; }
+};
+
+template <> struct value_gen<float> {
+    static float get(double x) { return x; }
+};
+
+template <> struct value_gen<long double> {
+    static long double get(double x) { return x; }
+};
+
+template <typename T> struct value_gen< std::vector<T> > {
+    static std::vector<T> get(double x) {
+        std::vector<T> v(3);
+        for (std::size_t i=0; i<v.size(); ++i) v[i]=x*(i+1);
+        return v;
+    }
+};
+
+class SetMergeTest : public ::testing::Test {
+  public:
+    static const int master=0;
+    alps::mpi::communicator comm;
+    aa::accumulator_set one_by_one;
+    aa::accumulator_set at_once;
+    std::vector<std::string> names;
+
+    SetMergeTest() {
+        add< aa::MeanAccumulator<double> >("mean");
+        add< aa::NoBinningAccumulator<dvec> >("nobin_vec");
+        add< aa::LogBinningAccumulator<double> >("logbin");
+        add< aa::LogBinningAccumulator<fvec> >("logbin_fvec");
+        add< aa::FullBinningAccumulator<double> >("fullbin");
+        add< aa::FullBinningAccumulator<dvec> >("fullbin_vec");
+        add< aa::FullBinningAccumulator<long double> >("fullbin_ld");
+        add< aa::NoBinningAccumulator<double> >("unmeasured");
+    }
+
+    template <typename A>
+    void add(const std::string& name) {
+        one_by_one << A(name);
+        at_once << A(name);
+        names.push_back(name);
+    }
+
+    // Uneven, rank-dependent number of samples, correlated within a rank
+    template <typename A>
+    void fill(const std::string& name) {
+        typedef typename aa::value_type<typename A::accumulator_type>::type value_type;
+        aa::testing::RandomData gen(comm.rank()+1);
+        const int n=1000+777*comm.rank();
+        double x=0;
+        for (int i=0; i<n; ++i) {
+            x=0.5*x+gen();
+            one_by_one[name] << value_gen<value_type>::get(x);
+            at_once[name] << value_gen<value_type>::get(x);
+        }
+    }
+
+    void fill_all() {
+        fill< aa::MeanAccumulator<double> >("mean");
+        fill< aa::NoBinningAccumulator<dvec> >("nobin_vec");
+        fill< aa::LogBinningAccumulator<double> >("logbin");
+        fill< aa::LogBinningAccumulator<fvec> >("logbin_fvec");
+        fill< aa::FullBinningAccumulator<double> >("fullbin");
+        fill< aa::FullBinningAccumulator<dvec> >("fullbin_vec");
+        fill< aa::FullBinningAccumulator<long double> >("fullbin_ld");
+    }
+
+    // MPI may add up the contributions of the ranks in a different order for a
+    // different buffer size, so the results agree up to rounding only
+    static void expect_near(long double lhs, long double rhs) {
+        EXPECT_NEAR(lhs, rhs, 1E-5*std::fabs(lhs));
+    }
+    template <typename T>
+    static void expect_near(std::vector<T> const& lhs, std::vector<T> const& rhs) {
+        ASSERT_EQ(lhs.size(), rhs.size());
+        for (std::size_t i=0; i<lhs.size(); ++i) expect_near(lhs[i], rhs[i]);
+    }
+
+    template <typename R>
+    static void compare_error(R const&, R const&, std::false_type) {}
+    template <typename R>
+    static void compare_error(R const& lhs, R const& rhs, std::true_type) {
+        expect_near(lhs.error(), rhs.error());
+    }
+
+    template <typename R>
+    static void compare_binning(R const&, R const&, std::false_type) {}
+    template <typename R>
+    static void compare_binning(R const& lhs, R const& rhs, std::true_type) {
+        EXPECT_EQ(lhs.binning_depth(), rhs.binning_depth());
+        expect_near(lhs.autocorrelation(), rhs.autocorrelation());
+    }
+
+    template <typename R>
+    static void compare_bins(R const&, R const&, std::false_type) {}
+    template <typename R>
+    static void compare_bins(R const& lhs, R const& rhs, std::true_type) {
+        EXPECT_EQ(lhs.max_num_binning().num_elements(), rhs.max_num_binning().num_elements());
+        expect_near(lhs.max_num_binning().bins(), rhs.max_num_binning().bins());
+    }
+
+    template <typename A>
+    void compare(const std::string& name) {
+        typedef typename A::accumulator_type raw_type;
+        SCOPED_TRACE(name);
+        const raw_type& lhs=one_by_one[name].extract<raw_type>();
+        const raw_type& rhs=at_once[name].extract<raw_type>();
+        EXPECT_EQ(lhs.count(), rhs.count());
+        if (lhs.count()==0) return;
+        expect_near(lhs.mean(), rhs.mean());
+        compare_error(lhs, rhs, typename aa::has_feature<raw_type, aa::error_tag>::type());
+        compare_binning(lhs, rhs, typename aa::has_feature<raw_type, aa::binning_analysis_tag>::type());
+        compare_bins(lhs, rhs, typename aa::has_feature<raw_type, aa::max_num_binning_tag>::type());
+    }
+};
+
+TEST_F(SetMergeTest, SameAsOneByOne) {
+    fill_all();
+
+    for (std::size_t i=0; i<names.size(); ++i) {
+        if (names[i]!="unmeasured") one_by_one[names[i]].collective_merge(comm, master);
+    }
+    std::vector<std::string> merged=aa::collective_merge(comm, at_once, names, master);
+
+    std::vector<std::string> expected_merged(names.begin(), names.end()-1);
+    EXPECT_EQ(expected_merged, merged);
+
+    compare< aa::MeanAccumulator<double> >("mean");
+    compare< aa::NoBinningAccumulator<dvec> >("nobin_vec");
+    compare< aa::LogBinningAccumulator<double> >("logbin");
+    compare< aa::LogBinningAccumulator<fvec> >("logbin_fvec");
+    compare< aa::FullBinningAccumulator<double> >("fullbin");
+    compare< aa::FullBinningAccumulator<dvec> >("fullbin_vec");
+    compare< aa::FullBinningAccumulator<long double> >("fullbin_ld");
+    EXPECT_EQ(0u, at_once["unmeasured"].count());
+
+    if (comm.rank()!=master) {
+        EXPECT_EQ(0u, at_once["fullbin"].count());
+    }
+}
+
+TEST_F(SetMergeTest, Subset) {
+    fill_all();
+
+    std::vector<std::string> subset;
+    subset.push_back("fullbin_vec");
+    subset.push_back("logbin");
+    one_by_one["fullbin_vec"].collective_merge(comm, master);
+    one_by_one["logbin"].collective_merge(comm, master);
+    EXPECT_EQ(subset, aa::collective_merge(comm, at_once, subset, master));
+
+    compare< aa::FullBinningAccumulator<dvec> >("fullbin_vec");
+    compare< aa::LogBinningAccumulator<double> >("logbin");
+    // not in the subset: untouched
+    compare< aa::MeanAccumulator<double> >("mean");
+}
+
+TEST_F(SetMergeTest, MeasuredOnSomeRanks) {
+    if (comm.size()<2) return;
+    if (comm.rank()==master) at_once["mean"] << 1.0;
+    EXPECT_THROW(aa::collective_merge(comm, at_once, names, master), std::runtime_error);
+}
+
+int main(int argc, char** argv)
+{
+   alps::mpi::environment env(argc, argv);
+   alps::gtest_par_xml_output tweak;
+   tweak(alps::mpi::communicator().rank(), argc, argv);
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
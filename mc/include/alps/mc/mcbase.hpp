@@ -12,12 +12,34 @@
 #include <alps/params.hpp>
 #include "random01.hpp"
 
+#include <future>
 #include <vector>
 #include <string>
 
 // move to alps::mcbase root scope
 namespace alps {
 
+    namespace detail {
+
+        /// Holds the background task of mcbase::save_async(); a copy is idle
+        class checkpoint_writer {
+            public:
+                checkpoint_writer() {}
+                checkpoint_writer(checkpoint_writer const &) {}
+                checkpoint_writer & operator=(checkpoint_writer const &) { return *this; }
+
+                /// Run `task` on a background thread
+                void start(boost::function<void ()> const & task);
+                /// Wait for the background task, if any; rethrows its exception
+                void wait();
+                /// Whether a background task was started and has not been waited for
+                bool pending() const { return task_.valid(); }
+
+            private:
+                std::future<void> task_;
+        };
+    }
+
     class mcbase {
 
         protected:
@@ -50,12 +72,33 @@ namespace alps {
             virtual void save(alps::hdf5::archive & ar) const;
             virtual void load(alps::hdf5::archive & ar);
 
+            /// Checkpoint to `filename` like save(std::string), writing the file on a background thread
+            /**
+               The state is serialized into an in-memory HDF5 image before the
+               call returns, so the simulation can continue at once. The image
+               is written to `filename + ".tmp"` in the background and renamed
+               to `filename` when complete, so `filename` always holds a complete
+               checkpoint. A previous background checkpoint is waited for first.
+             */
+            void save_async(std::string const & filename);
+            /// Wait for the checkpoint started by save_async(); rethrows an exception from writing it
+            void wait_for_save() const;
+
+        protected:
+
+            /// Serialize with `write` into an in-memory archive, then write it to `filename` in the background
+            void save_async(std::string const & filename, boost::function<void (alps::hdf5::archive &)> const & write);
+
         protected:
 
             parameters_type parameters;
             // parameters_type & params; // TODO: deprecated, remove!
             alps::random01 random;
             observable_collection_type measurements;
+
+        private:
+
+            mutable detail::checkpoint_writer checkpoint_writer_;
     };
 
     
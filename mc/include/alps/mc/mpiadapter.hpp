@@ -14,7 +14,11 @@
 #if defined(ALPS_HAVE_MPI)
 
 #include <alps/accumulators/mpi.hpp>
+#include <alps/accumulators/accumulator.hpp>
 #include <alps/mc/check_schedule.hpp>
+#include <alps/utilities/stacktrace.hpp>
+
+#include <stdexcept>
 
 namespace alps {
 
@@ -40,6 +44,11 @@ namespace alps {
                @param check Schedule checker object
                @param rng_seed_step RNG seed increase for each rank
                @param rng_seed_base RNG seed for rank 0
+
+               If the parameter `async_progress` is defined and `true`, the
+               progress reduction in run() is non-blocking (see run()).
+               This needs `MPI_Iallreduce`; without MPI-3 the constructor
+               throws `std::invalid_argument`.
              */
             mcmpiadapter_base(
                   parameters_type const & parameters
@@ -52,14 +61,46 @@ namespace alps {
                 , communicator(comm)
                 , schedule_checker(check)
                 , clone(comm.rank())
-            {}
+                , async_progress(parameters.defined("async_progress") && parameters["async_progress"].template as<bool>())
+            {
+#if !(MPI_VERSION >= 3)
+                if (async_progress)
+                    throw std::invalid_argument("async_progress requires MPI_Iallreduce (MPI-3 or later)" + ALPS_STACKTRACE);
+#endif
+            }
 
        public:
+            /// Define the parameters of the wrapped class and `async_progress`
+            static parameters_type& define_parameters(parameters_type & parameters) {
+                Base::define_parameters(parameters);
+                if (parameters.is_restored()) return parameters;
+                parameters.template define<bool>("async_progress", false, "use non-blocking reduction of the completed fraction (requires MPI-3)");
+                return parameters;
+            }
+
             double fraction_completed() const {
                 return fraction;
             }
 
+            /// Run the simulation until all ranks are done or stopped
+            /**
+               In the default mode each progress check is a blocking
+               all-reduce of the completed fraction, so every rank waits
+               for the slowest one.
+
+               With `async_progress` the reduction is started with
+               `MPI_Iallreduce` and the rank keeps calling
+               `update()`/`measure()` while it is in flight, testing for
+               completion after every step. The schedule checker and the
+               termination decision only see the result once it has
+               arrived. A new reduction is started only after the previous
+               one completes, so all ranks see the same sequence of
+               reduced values and stop at the same one.
+             */
             bool run(boost::function<bool ()> const & stop_callback) {
+#if MPI_VERSION >= 3
+                if (async_progress) return run_async(stop_callback);
+#endif
                 bool done = false, stopped = false;
                 do {
                     this->update();
@@ -74,26 +115,44 @@ namespace alps {
                 return !stopped;
             }
 
+        private:
+#if MPI_VERSION >= 3
+            bool run_async(boost::function<bool ()> const & stop_callback) {
+                bool done = false, stopped = false, in_flight = false;
+                double local_fraction = 0., global_fraction = 0.;
+                MPI_Request request = MPI_REQUEST_NULL;
+                do {
+                    this->update();
+                    this->measure();
+                    if (in_flight) {
+                        if (alps::mpi::test(request)) {
+                            in_flight = false;
+                            schedule_checker.update(fraction = global_fraction);
+                            done = fraction >= 1.;
+                        }
+                    } else if (stopped || schedule_checker.pending()) {
+                        stopped = stop_callback();
+                        local_fraction = stopped ? 1. : Base::fraction_completed();
+                        request = alps::mpi::i_all_reduce(communicator, local_fraction, global_fraction, std::plus<double>());
+                        in_flight = true;
+                    }
+                } while(!done);
+                return !stopped;
+            }
+#endif
+
+        public:
+
             typename Base::results_type collect_results() const {
                 return collect_results(this->result_names());
             }
 
             typename Base::results_type collect_results(typename Base::result_names_type const & names) const {
                 typename Base::results_type partial_results;
-                for(typename Base::result_names_type::const_iterator it = names.begin(); it != names.end(); ++it) {
-                    size_t has_count=(this->measurements[*it].count() > 0);
-                    const size_t sum_counts =
-                            alps::mpi::all_reduce(communicator,
-                                                  has_count,
-                                                  std::plus<size_t>());
-                    if (static_cast<int>(sum_counts) == communicator.size()) {
-                        typename Base::observable_collection_type::value_type merged = this->measurements[*it];
-                        merged.collective_merge(communicator, 0);
-                        partial_results.insert(*it, merged.result());
-                    } else if (sum_counts > 0 && static_cast<int>(sum_counts) < communicator.size()) {
-                        throw std::runtime_error(*it + " was measured on only some of the MPI processes.");
-                    }
-                }
+                // merges all observables at once, with a fixed number of MPI collectives
+                const std::vector<std::string> merged = alps::accumulators::collective_merge(communicator, this->measurements, names, 0);
+                for(std::vector<std::string>::const_iterator it = merged.begin(); it != merged.end(); ++it)
+                    partial_results.insert(*it, this->measurements[*it].result());
                 return partial_results;
             }
 
@@ -104,6 +163,7 @@ namespace alps {
             ScheduleChecker schedule_checker;
             double fraction;
             int clone;
+            bool async_progress;
         };
     } // detail::
 
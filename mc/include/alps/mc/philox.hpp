@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#pragma once
+
+#include <boost/cstdint.hpp>
+
+#include <cstddef>
+#include <limits>
+
+namespace alps {
+
+    /// Counter-based random number engine Philox4x32-10 (Salmon et al., SC'11)
+    /**
+       The output is a pure function of a 64-bit key (the seed), a 64-bit
+       stream id and a 64-bit position, so independent streams need no
+       seeding heuristics, skipping ahead is O(1) and the whole state is
+       three integers.
+
+       Models a uniform random bit generator with 32-bit output; the
+       32-bit words of stream `s` are the output blocks of the counters
+       `{0,0,lo(s),hi(s)}`, `{1,0,lo(s),hi(s)}`, ..., four words per block.
+     */
+    class philox4x32 {
+        public:
+            typedef boost::uint32_t result_type;
+            typedef boost::uint64_t size_type;
+
+            /// Counter (4 words) and key (2 words) of one block
+            typedef boost::uint32_t counter_type[4];
+            typedef boost::uint32_t key_type[2];
+
+            /// Number of blocks processed together by the bulk functions
+            static const std::size_t batch_size = 8;
+
+            static result_type min() { return 0; }
+            static result_type max() { return std::numeric_limits<result_type>::max(); }
+
+            /// Construct the engine for the given seed (key) and stream id, positioned at the stream start
+            explicit philox4x32(size_type seed = 42, size_type stream = 0)
+                : seed_(seed), stream_(stream), position_(0), cached_block_(0), cache_valid_(false)
+            {}
+
+            /// Next 32-bit word of the stream
+            result_type operator()() {
+                const size_type block = position_ >> 2;
+                if (!cache_valid_ || block != cached_block_) {
+                    counter_type ctr;
+                    set_counter(ctr, block);
+                    key_type key = { lo(seed_), hi(seed_) };
+                    generate_block(ctr, key, cache_);
+                    cached_block_ = block;
+                    cache_valid_ = true;
+                }
+                return cache_[position_++ & 3];
+            }
+
+            /// Skip `n` words in O(1)
+            void discard(size_type n) { position_ += n; }
+
+            /// Fill `out[0..n)` with uniform doubles in [0,1), each made of two consecutive words
+            /**
+               Gives the same values as `n` calls of uniform(). Whole blocks
+               are generated `batch_size` at a time in structure-of-arrays
+               form so that the compiler can vectorize the rounds.
+             */
+            void uniform(double * out, std::size_t n) {
+                // align to a block boundary so that whole blocks map to pairs of doubles
+                while (n > 0 && (position_ & 3) != 0) { *out++ = uniform(); --n; }
+                key_type key = { lo(seed_), hi(seed_) };
+                boost::uint32_t c0[batch_size], c1[batch_size], c2[batch_size], c3[batch_size];
+                while (n >= 2 * batch_size) {
+                    const size_type block = position_ >> 2;
+                    for (std::size_t j = 0; j < batch_size; ++j) {
+                        c0[j] = lo(block + j); c1[j] = hi(block + j);
+                        c2[j] = lo(stream_);   c3[j] = hi(stream_);
+                    }
+                    generate_batch(c0, c1, c2, c3, key);
+                    for (std::size_t j = 0; j < batch_size; ++j) {
+                        out[2 * j] = to_double(c0[j], c1[j]);
+                        out[2 * j + 1] = to_double(c2[j], c3[j]);
+                    }
+                    position_ += 4 * batch_size;
+                    out += 2 * batch_size;
+                    n -= 2 * batch_size;
+                }
+                while (n > 0) { *out++ = uniform(); --n; }
+            }
+
+            /// Next uniform double in [0,1) with 53 random bits
+            double uniform() {
+                const result_type a = (*this)();
+                const result_type b = (*this)();
+                return to_double(a, b);
+            }
+
+            size_type seed() const { return seed_; }
+            size_type stream() const { return stream_; }
+            /// Number of words consumed from the stream so far
+            size_type position() const { return position_; }
+
+            /// Reposition the engine; this is all the state needed to restore it
+            void set_state(size_type seed, size_type stream, size_type position) {
+                seed_ = seed;
+                stream_ = stream;
+                position_ = position;
+                cache_valid_ = false;
+            }
+
+            /// The Philox4x32-10 bijection: 10 rounds on one counter block with the given key
+            static void generate_block(counter_type const & ctr, key_type const & key, counter_type & out) {
+                boost::uint32_t c0[1] = { ctr[0] }, c1[1] = { ctr[1] }, c2[1] = { ctr[2] }, c3[1] = { ctr[3] };
+                round_batch<1>(c0, c1, c2, c3, key);
+                out[0] = c0[0]; out[1] = c1[0]; out[2] = c2[0]; out[3] = c3[0];
+            }
+
+            friend bool operator==(philox4x32 const & lhs, philox4x32 const & rhs) {
+                return lhs.seed_ == rhs.seed_ && lhs.stream_ == rhs.stream_ && lhs.position_ == rhs.position_;
+            }
+            friend bool operator!=(philox4x32 const & lhs, philox4x32 const & rhs) {
+                return !(lhs == rhs);
+            }
+
+        private:
+            static boost::uint32_t lo(size_type x) { return static_cast<boost::uint32_t>(x); }
+            static boost::uint32_t hi(size_type x) { return static_cast<boost::uint32_t>(x >> 32); }
+
+            static double to_double(boost::uint32_t a, boost::uint32_t b) {
+                // same construction as genrand_res53() of the reference MT19937
+                return ((a >> 5) * 67108864.0 + (b >> 6)) * (1.0 / 9007199254740992.0);
+            }
+
+            void set_counter(counter_type & ctr, size_type block) const {
+                ctr[0] = lo(block); ctr[1] = hi(block);
+                ctr[2] = lo(stream_); ctr[3] = hi(stream_);
+            }
+
+            static void generate_batch(boost::uint32_t * c0, boost::uint32_t * c1, boost::uint32_t * c2, boost::uint32_t * c3, key_type const & key) {
+                round_batch<batch_size>(c0, c1, c2, c3, key);
+            }
+
+            /// 10 rounds on `N` independent blocks stored as structure of arrays
+            template<std::size_t N>
+            static void round_batch(boost::uint32_t * c0, boost::uint32_t * c1, boost::uint32_t * c2, boost::uint32_t * c3, key_type const & key) {
+                boost::uint32_t k0 = key[0], k1 = key[1];
+                for (int r = 0; r < 10; ++r) {
+                    for (std::size_t j = 0; j < N; ++j) {
+                        const boost::uint64_t p0 = boost::uint64_t(0xD2511F53u) * c0[j];
+                        const boost::uint64_t p1 = boost::uint64_t(0xCD9E8D57u) * c2[j];
+                        const boost::uint32_t n0 = static_cast<boost::uint32_t>(p1 >> 32) ^ c1[j] ^ k0;
+                        const boost::uint32_t n2 = static_cast<boost::uint32_t>(p0 >> 32) ^ c3[j] ^ k1;
+                        c1[j] = static_cast<boost::uint32_t>(p1);
+                        c3[j] = static_cast<boost::uint32_t>(p0);
+                        c0[j] = n0;
+                        c2[j] = n2;
+                    }
+                    k0 += 0x9E3779B9u;
+                    k1 += 0xBB67AE85u;
+                }
+            }
+
+            size_type seed_;
+            size_type stream_;
+            size_type position_;
+            size_type cached_block_;
+            bool cache_valid_;
+            counter_type cache_;
+    };
+
+}
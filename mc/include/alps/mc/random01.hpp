@@ -7,31 +7,181 @@
 #pragma once
 
 #include <alps/hdf5/archive.hpp>
+#include <alps/hdf5/vector.hpp>
+#include <alps/mc/philox.hpp>
+#include <alps/utilities/stacktrace.hpp>
 
+#include <boost/align/aligned_allocator.hpp>
 #include <boost/random.hpp>
 
+#include <algorithm>
+#include <stdexcept>
 #include <string>
 #include <sstream>
+#include <vector>
 
 namespace alps {
 
+    /// Uniform random numbers in [0,1), from a Mersenne twister or from the counter-based Philox4x32-10 engine
+    /**
+       With `MT19937` (the default) the generator is seeded with `seed+stream`.
+       With `PHILOX4X32` the seed is the key and `stream` selects an
+       independent stream, e.g. the MPI rank or thread number; see philox4x32.
+
+       fill() generates many numbers at once. In buffered mode (see
+       set_buffer_size()) operator() hands out numbers from a block that is
+       refilled with fill(), so tight loops avoid the per-call overhead.
+     */
     struct random01 : public boost::variate_generator<boost::mt19937, boost::uniform_01<double> > {
+        typedef boost::variate_generator<boost::mt19937, boost::uniform_01<double> > mt_generator_type;
+
+        /// Engine behind the generator
+        enum engine_kind { MT19937, PHILOX4X32 };
+
         random01(int seed = 42)
-            : boost::variate_generator<boost::mt19937, boost::uniform_01<double> >(boost::mt19937(seed), boost::uniform_01<double>())
+            : mt_generator_type(boost::mt19937(seed), boost::uniform_01<double>())
+            , kind_(MT19937)
+            , buffer_pos_(0)
+        {}
+
+        /// Construct a generator with the given engine for the given stream
+        random01(engine_kind kind, std::size_t seed, std::size_t stream)
+            : mt_generator_type(boost::mt19937(kind == MT19937 ? seed + stream : seed), boost::uniform_01<double>())
+            , kind_(kind)
+            , philox_(seed, stream)
+            , buffer_pos_(0)
         {}
 
+        /// Engine kind by name: "mt19937" or "philox"; throws `std::invalid_argument` otherwise
+        static engine_kind engine_from_name(std::string const & name) {
+            if (name == "mt19937") return MT19937;
+            if (name == "philox") return PHILOX4X32;
+            throw std::invalid_argument("Unknown random number engine: '" + name + "'" + ALPS_STACKTRACE);
+        }
+
+        engine_kind engine_type() const { return kind_; }
+
+        double operator()() {
+            if (buffer_pos_ != buffer_.size())
+                return buffer_[buffer_pos_++];
+            if (!buffer_.empty()) {
+                generate(buffer_.data(), buffer_.size());
+                buffer_pos_ = 0;
+                return buffer_[buffer_pos_++];
+            }
+            return kind_ == PHILOX4X32 ? philox_.uniform() : mt_generator_type::operator()();
+        }
+
+        /// Write the next `n` random numbers to `out`; gives the same numbers as `n` calls of operator()
+        void fill(double * out, std::size_t n) {
+            const std::size_t buffered = std::min(n, buffer_.size() - buffer_pos_);
+            std::copy(buffer_.begin() + buffer_pos_, buffer_.begin() + buffer_pos_ + buffered, out);
+            buffer_pos_ += buffered;
+            generate(out + buffered, n - buffered);
+        }
+
+        /// Hand out numbers from a block of `size` numbers refilled at once; 0 (the default) disables buffering
+        /**
+           Buffering does not change the sequence of numbers. A checkpoint
+           of a buffered Philox generator resumes exactly; a buffered
+           Mersenne twister resumes after the numbers already generated
+           into the block, and so does a Mersenne twister whose buffer
+           size is changed.
+         */
+        void set_buffer_size(std::size_t size) {
+            rewind_buffer();
+            buffer_.assign(size, 0.);
+            buffer_pos_ = size;
+        }
+
+        std::size_t buffer_size() const { return buffer_.size(); }
+
+        /// Skip `n` random numbers; O(1) with the Philox engine, O(n) with the Mersenne twister
+        void discard(boost::uint64_t n) {
+            const std::size_t buffered = buffer_.size() - buffer_pos_;
+            if (n <= buffered) {
+                buffer_pos_ += n;
+                return;
+            }
+            buffer_pos_ = buffer_.size();
+            n -= buffered;
+            if (kind_ == PHILOX4X32)
+                philox_.discard(2 * n);
+            else
+                for (; n > 0; --n) mt_generator_type::operator()();
+        }
+
         void save(alps::hdf5::archive & ar) const { // TODO: move this to hdf5 archive!
+            if (kind_ == PHILOX4X32) {
+                // the whole state is three integers
+                std::vector<unsigned long long> state(3);
+                state[0] = philox_.seed();
+                state[1] = philox_.stream();
+                // numbers still in the buffer are generated again after loading
+                state[2] = philox_.position() - 2 * (buffer_.size() - buffer_pos_);
+                ar["engine_type"] << std::string("philox4x32");
+                ar["philox"] << state;
+                return;
+            }
             std::ostringstream os;
             os << this->engine();
             ar["engine"] << os.str();
         }
 
         void load(alps::hdf5::archive & ar) { // TODO: move this to hdf5 archive!
+            if (ar.is_data("engine_type")) {
+                std::string type;
+                ar["engine_type"] >> type;
+                if (type != "philox4x32")
+                    throw std::runtime_error("Unknown random number engine in checkpoint: '" + type + "'" + ALPS_STACKTRACE);
+                std::vector<unsigned long long> state;
+                ar["philox"] >> state;
+                if (state.size() != 3)
+                    throw std::runtime_error("Invalid philox4x32 checkpoint" + ALPS_STACKTRACE);
+                philox_.set_state(state[0], state[1], state[2]);
+                kind_ = PHILOX4X32;
+                buffer_pos_ = buffer_.size();
+                return;
+            }
             std::string state;
             ar["engine"] >> state;
             std::istringstream is(state);
             is >> this->engine();
+            kind_ = MT19937;
+            buffer_pos_ = buffer_.size();
         }
+
+        private:
+            /// Write the next `n` numbers of the engine to `out`, bypassing the buffer
+            void generate(double * out, std::size_t n) {
+                if (kind_ == PHILOX4X32) {
+                    philox_.uniform(out, n);
+                    return;
+                }
+                // uniform_01 maps a 32-bit word w to w/2^32; generate the words first, then convert them in one loop
+                const std::size_t block = 256;
+                boost::uint32_t words[block];
+                while (n > 0) {
+                    const std::size_t m = n < block ? n : block;
+                    for (std::size_t i = 0; i < m; ++i) words[i] = this->engine()();
+                    for (std::size_t i = 0; i < m; ++i) out[i] = words[i] * (1. / 4294967296.);
+                    out += m;
+                    n -= m;
+                }
+            }
+
+            /// Return the unused buffered numbers to the engine where possible
+            void rewind_buffer() {
+                if (kind_ == PHILOX4X32)
+                    philox_.set_state(philox_.seed(), philox_.stream(), philox_.position() - 2 * (buffer_.size() - buffer_pos_));
+                buffer_pos_ = buffer_.size();
+            }
+
+            engine_kind kind_;
+            philox4x32 philox_;
+            /// Buffered numbers, on their own cache lines; buffer_[buffer_pos_..) are still unused
+            std::vector<double, boost::alignment::aligned_allocator<double, 64> > buffer_;
+            std::size_t buffer_pos_;
     };
 
 }
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+#pragma once
+
+#include <boost/function.hpp>
+
+#include <alps/config.hpp>
+#include <alps/accumulators/accumulator.hpp>
+#include <alps/utilities/stacktrace.hpp>
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace alps {
+
+    /// Shared-memory adapter for an MC simulation class: runs several clones on threads of one process
+    /**
+       The adapter object itself is clone 0 and runs on the thread calling
+       run(); clones 1 to `nthreads-1` are separate `Base` objects, each on
+       its own thread. Every clone has its own `random01` stream and its own
+       measurements, so the Markov chains never touch shared data.
+
+       The completed fraction is the sum over all clones, as with
+       mcmpiadapter. Each clone publishes its own fraction to a padded
+       atomic slot after every step; reading the combined fraction takes no
+       lock.
+
+       @note collect_results() merges the measurements of all clones, so
+       every accumulator must support `merge()` (FullBinningAccumulator
+       does not).
+
+       @tparam Base a single-process simulation class to be wrapped
+     */
+    template<typename Base> class mcthreadadapter : public Base {
+        public:
+            typedef typename Base::parameters_type parameters_type;
+            typedef typename Base::results_type results_type;
+            typedef typename Base::result_names_type result_names_type;
+
+            using Base::save;
+            using Base::load;
+
+            /// Construct mcthreadadapter with `nthreads` clones
+            /**
+               Clone `i` is constructed with the RNG seed offset `i*rng_seed_step + rng_seed_base`.
+
+               @param parameters Parameters object for the wrapped simulation class
+               @param nthreads Number of clones (and threads); must be positive
+               @param rng_seed_step RNG seed increase for each clone
+               @param rng_seed_base RNG seed for clone 0
+             */
+            mcthreadadapter(
+                  parameters_type const & parameters
+                , std::size_t nthreads
+                , int rng_seed_step = 1
+                , int rng_seed_base = 0
+            )
+                : Base(parameters, rng_seed_base)
+                , progress(new progress_slot[nthreads > 0 ? nthreads : 1])
+            {
+                if (nthreads == 0) throw std::invalid_argument("mcthreadadapter needs at least one thread" + ALPS_STACKTRACE);
+                for (std::size_t i = 1; i < nthreads; ++i)
+                    clones.push_back(std::unique_ptr<clone_type>(new clone_type(parameters, i*rng_seed_step + rng_seed_base)));
+                update_progress();
+            }
+
+            /// Number of clones (and threads)
+            std::size_t num_threads() const { return clones.size() + 1; }
+
+            /// Combined completed fraction of all clones
+            double fraction_completed() const {
+                double fraction = 0.;
+                for (std::size_t i = 0; i < num_threads(); ++i)
+                    fraction += progress[i].fraction.load(std::memory_order_relaxed);
+                return fraction;
+            }
+
+            /// Run all clones until the combined fraction reaches 1 or `stop_callback` returns `true`
+            /**
+               `stop_callback` is called only on the calling thread (clone 0),
+               once per step as in mcbase::run(). An exception thrown by any
+               clone stops all of them and is rethrown here.
+             */
+            bool run(boost::function<bool ()> const & stop_callback) {
+                update_progress();
+                std::atomic<bool> done(false);
+                std::vector<std::exception_ptr> errors(clones.size());
+                std::vector<std::thread> threads;
+                bool stopped = false;
+                try {
+                    for (std::size_t i = 0; i < clones.size(); ++i)
+                        threads.push_back(std::thread(&mcthreadadapter::run_clone, this, i, std::ref(done), std::ref(errors[i])));
+                    while (!done.load(std::memory_order_acquire)
+                           && !(stopped = stop_callback()) && fraction_completed() < 1.) {
+                        this->update();
+                        this->measure();
+                        progress[0].fraction.store(Base::fraction_completed(), std::memory_order_relaxed);
+                    }
+                } catch (...) {
+                    done.store(true, std::memory_order_release);
+                    for (std::size_t i = 0; i < threads.size(); ++i) threads[i].join();
+                    throw;
+                }
+                done.store(true, std::memory_order_release);
+                for (std::size_t i = 0; i < threads.size(); ++i) threads[i].join();
+                for (std::size_t i = 0; i < errors.size(); ++i)
+                    if (errors[i]) std::rethrow_exception(errors[i]);
+                update_progress();
+                return !stopped;
+            }
+
+            results_type collect_results() const {
+                return collect_results(this->result_names());
+            }
+
+            /// Merge the measurements of all clones with wrapper_set::merge and return the named results
+            results_type collect_results(result_names_type const & names) const {
+                typename Base::observable_collection_type merged;
+                for (typename Base::observable_collection_type::const_iterator it = this->measurements.begin(); it != this->measurements.end(); ++it)
+                    merged.insert(it->first, std::shared_ptr<alps::accumulators::accumulator_wrapper>(it->second->new_clone()));
+                for (std::size_t i = 0; i < clones.size(); ++i)
+                    merged.merge(clones[i]->observables());
+                results_type partial_results;
+                for (typename result_names_type::const_iterator it = names.begin(); it != names.end(); ++it)
+                    partial_results.insert(*it, merged[*it].result());
+                return partial_results;
+            }
+
+            /// Save all clones to `/simulation/realizations/0/clones/<i>`
+            void save(std::string const & filename) const {
+                this->wait_for_save();
+                alps::hdf5::archive ar(filename, "w");
+                save_clones(ar);
+            }
+
+            /// Load all clones saved by save(std::string)
+            void load(std::string const & filename) {
+                this->wait_for_save();
+                alps::hdf5::archive ar(filename);
+                ar["/simulation/realizations/0/clones/0"] >> *this;
+                for (std::size_t i = 0; i < clones.size(); ++i)
+                    ar["/simulation/realizations/0/clones/" + std::to_string(i + 1)] >> *clones[i];
+                update_progress();
+            }
+
+            /// Save all clones like save(std::string), writing the file on a background thread; see mcbase::save_async()
+            void save_async(std::string const & filename) {
+                Base::save_async(filename, [this](alps::hdf5::archive & ar) { this->save_clones(ar); });
+            }
+
+        private:
+            /// Worker clone; gives the adapter read access to its measurements
+            class clone_type : public Base {
+                public:
+                    clone_type(parameters_type const & parameters, std::size_t seed_offset)
+                        : Base(parameters, seed_offset)
+                    {}
+
+                    typename Base::observable_collection_type const & observables() const {
+                        return this->measurements;
+                    }
+            };
+
+            /// Completed fraction of one clone, on its own cache line
+            struct progress_slot {
+                progress_slot() : fraction(0.) {}
+                std::atomic<double> fraction;
+                char padding[64 - sizeof(std::atomic<double>)];
+            };
+
+            /// Loop of clone `i+1`, run on its own thread
+            void run_clone(std::size_t i, std::atomic<bool> & done, std::exception_ptr & error) {
+                try {
+                    clone_type & clone = *clones[i];
+                    while (!done.load(std::memory_order_acquire)) {
+                        clone.update();
+                        clone.measure();
+                        progress[i + 1].fraction.store(clone.fraction_completed(), std::memory_order_relaxed);
+                    }
+                } catch (...) {
+                    error = std::current_exception();
+                    done.store(true, std::memory_order_release);
+                }
+            }
+
+            void save_clones(alps::hdf5::archive & ar) const {
+                ar["/simulation/realizations/0/clones/0"] << *this;
+                for (std::size_t i = 0; i < clones.size(); ++i)
+                    ar["/simulation/realizations/0/clones/" + std::to_string(i + 1)] << *clones[i];
+            }
+
+            /// Refresh all progress slots while no clone is running
+            void update_progress() {
+                progress[0].fraction.store(Base::fraction_completed(), std::memory_order_relaxed);
+                for (std::size_t i = 0; i < clones.size(); ++i)
+                    progress[i + 1].fraction.store(clones[i]->fraction_completed(), std::memory_order_relaxed);
+            }
+
+            std::vector<std::unique_ptr<clone_type> > clones;
+            std::unique_ptr<progress_slot[]> progress;
+    };
+
+}
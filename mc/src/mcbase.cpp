@@ -5,31 +5,85 @@
  */
 
 #include <alps/utilities/signal.hpp>
+#include <alps/utilities/stacktrace.hpp>
 #include <alps/mc/mcbase.hpp>
 
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
 namespace alps {
 
+    namespace detail {
+
+        void checkpoint_writer::start(boost::function<void ()> const & task) {
+            wait();
+            task_ = std::async(std::launch::async, task);
+        }
+
+        void checkpoint_writer::wait() {
+            if (task_.valid())
+                task_.get();
+        }
+
+        /// Close the in-memory archive, which writes it to disk, and move the file into place
+        void finish_checkpoint(std::shared_ptr<alps::hdf5::archive> archive, std::string const & tmpname, std::string const & filename) {
+            archive->close();
+            archive.reset();
+            if (std::rename(tmpname.c_str(), filename.c_str()) != 0)
+                throw std::runtime_error("Cannot rename checkpoint '" + tmpname + "' to '" + filename + "'" + ALPS_STACKTRACE);
+        }
+    }
+
     mcbase::mcbase(parameters_type const & parms, std::size_t seed_offset)
         : parameters(parms)
-        , random(std::size_t(parameters["SEED"]) + seed_offset)
+        , random(random01::engine_from_name(parameters.defined("RNG") ? parameters["RNG"].as<std::string>() : "mt19937"),
+                 std::size_t(parameters["SEED"]), seed_offset)
     {
         alps::signal::listen();
     }
 
     mcbase::parameters_type& mcbase::define_parameters(parameters_type & parameters) {
-        return parameters.define<long>("SEED", 42, "PRNG seed");
+        return parameters
+            .define<long>("SEED", 42, "PRNG seed")
+            .define<std::string>("RNG", "mt19937", "PRNG engine: mt19937 (seeded with SEED plus the clone's seed offset) "
+                                 "or philox (counter-based, key SEED, one stream per clone)");
     }
 
   void mcbase::save(std::string const & filename) const {
+        checkpoint_writer_.wait();
         alps::hdf5::archive ar(filename, "w");
         ar["/simulation/realizations/0/clones/0"] << *this;
     }
 
     void mcbase::load(std::string const & filename) {
+        checkpoint_writer_.wait();
         alps::hdf5::archive ar(filename);
         ar["/simulation/realizations/0/clones/0"] >> *this;
     }
 
+    void mcbase::save_async(std::string const & filename) {
+        save_async(filename, [this](alps::hdf5::archive & ar) {
+            ar["/simulation/realizations/0/clones/0"] << *this;
+        });
+    }
+
+    void mcbase::save_async(std::string const & filename, boost::function<void (alps::hdf5::archive &)> const & write) {
+        checkpoint_writer_.wait();
+        const std::string tmpname = filename + ".tmp";
+        // the archive would otherwise append to a stale temporary file
+        std::remove(tmpname.c_str());
+        std::shared_ptr<alps::hdf5::archive> archive(new alps::hdf5::archive(tmpname, "wm"));
+        write(*archive);
+        checkpoint_writer_.start([archive, tmpname, filename]() {
+            detail::finish_checkpoint(archive, tmpname, filename);
+        });
+    }
+
+    void mcbase::wait_for_save() const {
+        checkpoint_writer_.wait();
+    }
+
     bool mcbase::run(boost::function<bool ()> const & stop_callback) {
         bool stopped = false;
         while(!(stopped = stop_callback()) && fraction_completed() < 1.) {
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file async_checkpoint.cpp
+    Test background checkpointing with mcbase::save_async()
+*/
+
+#include <alps/mc/mcbase.hpp>
+
+#include <alps/testing/unique_file.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+
+// Simulation measuring uniform random numbers
+class my_sim_type : public alps::mcbase {
+    int count_;
+  public:
+    using alps::mcbase::save;
+    using alps::mcbase::load;
+
+    my_sim_type(const parameters_type& p, std::size_t offset=0)
+        : alps::mcbase(p,offset), count_(0)
+    {
+        measurements << alps::accumulators::FullBinningAccumulator<double>("X")
+                     << alps::accumulators::FullBinningAccumulator<std::vector<double> >("V");
+    }
+
+    void update() { ++count_; }
+
+    void measure() {
+        const double x=random();
+        measurements["X"] << x;
+        measurements["V"] << std::vector<double>(10, x);
+    }
+
+    double fraction_completed() const { return 0.; }
+
+    int count() const { return count_; }
+
+    void save(alps::hdf5::archive & ar) const {
+        alps::mcbase::save(ar);
+        ar["count"] << count_;
+    }
+
+    void load(alps::hdf5::archive & ar) {
+        alps::mcbase::load(ar);
+        ar["count"] >> count_;
+    }
+
+    void steps(int n) {
+        for (int i=0; i<n; ++i) { update(); measure(); }
+    }
+};
+
+static bool exists(std::string const & name) {
+    return std::ifstream(name.c_str()).good();
+}
+
+class AsyncCheckpointTest : public ::testing::Test {
+  public:
+    alps::params p;
+    alps::testing::unique_file ufile;
+    AsyncCheckpointTest() : ufile("async_checkpoint.h5.", alps::testing::unique_file::REMOVE_AFTER) {
+        my_sim_type::define_parameters(p);
+    }
+    ~AsyncCheckpointTest() {
+        std::remove((ufile.name()+".tmp").c_str());
+    }
+};
+
+// The checkpoint holds the state at the time of the call, not when the file is written
+TEST_F(AsyncCheckpointTest, Snapshot) {
+    my_sim_type sim(p);
+    sim.steps(10000);
+    const double xmean=sim.collect_results()["X"].mean<double>();
+    sim.save_async(ufile.name());
+    sim.steps(1000);
+    sim.wait_for_save();
+    EXPECT_FALSE(exists(ufile.name()+".tmp"));
+
+    my_sim_type sim2(p);
+    sim2.load(ufile.name());
+    EXPECT_EQ(10000, sim2.count());
+    alps::accumulators::result_set results=sim2.collect_results();
+    EXPECT_EQ(10000u, results["X"].count());
+    EXPECT_EQ(xmean, results["X"].mean<double>());
+}
+
+// A restarted simulation continues exactly like the original
+TEST_F(AsyncCheckpointTest, SameAsSave) {
+    my_sim_type sim(p);
+    sim.steps(500);
+    sim.save_async(ufile.name());
+    sim.wait_for_save();
+
+    my_sim_type sim2(p);
+    sim2.load(ufile.name());
+    sim.steps(500);
+    sim2.steps(500);
+    EXPECT_EQ(sim.collect_results()["X"].mean<double>(), sim2.collect_results()["X"].mean<double>());
+}
+
+// Checkpoints in a row replace each other; a stale temporary file is ignored
+TEST_F(AsyncCheckpointTest, Repeated) {
+    {
+        std::ofstream stale((ufile.name()+".tmp").c_str());
+        stale << "not hdf5";
+    }
+    my_sim_type sim(p);
+    for (int i=0; i<5; ++i) {
+        sim.steps(100);
+        sim.save_async(ufile.name());
+    }
+    // save() waits for the background checkpoint before writing
+    sim.steps(100);
+    sim.save(ufile.name());
+
+    my_sim_type sim2(p);
+    sim2.load(ufile.name());
+    EXPECT_EQ(600, sim2.count());
+    EXPECT_FALSE(exists(ufile.name()+".tmp"));
+}
+
+// A copy of a simulation does not share its background checkpoint
+TEST_F(AsyncCheckpointTest, Copy) {
+    my_sim_type sim(p);
+    sim.steps(100);
+    sim.save_async(ufile.name());
+    my_sim_type copy(sim);
+    copy.wait_for_save();
+    sim.wait_for_save();
+    EXPECT_TRUE(exists(ufile.name()));
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file async_progress.cpp
+    Test the non-blocking progress reduction of mcmpiadapter::run()
+*/
+
+#include <alps/mc/mcbase.hpp>
+#include <alps/mc/mpiadapter.hpp>
+#include <alps/mc/api.hpp>
+#include <alps/mc/stop_callback.hpp>
+
+#include <gtest/gtest.h>
+
+// Simulation where ranks advance at different speeds
+class my_sim_type : public alps::mcbase {
+    int count_;
+    int step_;
+  public:
+    enum { MAXCOUNT=1000 };
+
+    my_sim_type(const parameters_type& p, std::size_t offset=0) : alps::mcbase(p,offset), count_(0), step_(1)
+    {
+        measurements << alps::accumulators::NoBinningAccumulator<double>("X");
+    }
+
+    void set_step(int step) { step_=step; }
+
+    void update() { count_ += step_; }
+
+    void measure() { measurements["X"] << double(count_); }
+
+    double fraction_completed() const { return (count_<MAXCOUNT)?0:1; }
+
+    int count() const { return count_; }
+};
+
+// Checks progress after every step
+class my_schecker_type {
+  public:
+    my_schecker_type() {}
+    bool pending() const { return true; }
+    void update(double /*f*/) {}
+};
+
+static bool stop_callback() { return false; }
+
+TEST(AsyncProgress,Params) {
+    typedef alps::mcmpiadapter<my_sim_type,my_schecker_type> sim_type;
+    alps::params p;
+    sim_type::define_parameters(p);
+
+    ASSERT_TRUE(p.defined("async_progress"));
+    EXPECT_FALSE(p["async_progress"].as<bool>());
+}
+
+TEST(AsyncProgress,Run) {
+    typedef alps::mcmpiadapter<my_sim_type,my_schecker_type> sim_type;
+    alps::mpi::communicator comm;
+    alps::params p;
+    sim_type::define_parameters(p);
+    p["async_progress"]=true;
+
+    sim_type sim(p, comm, my_schecker_type());
+    sim.set_step(comm.rank()+1);
+    EXPECT_TRUE(sim.run(stop_callback));
+
+    // the fractions are summed, so the run ends once the fastest rank is done;
+    // all ranks must stop on the same reduced value
+    const double fraction=sim.fraction_completed();
+    EXPECT_GE(fraction, 1.);
+    EXPECT_EQ(fraction, alps::mpi::all_reduce(comm, fraction, alps::mpi::maximum<double>()));
+    EXPECT_GT(sim.count(), 0);
+
+    alps::accumulators::result_set results = sim.collect_results();
+    if (comm.rank()==0) {
+        EXPECT_TRUE(results.has("X"));
+    }
+}
+
+TEST(AsyncProgress,Stop) {
+    typedef alps::mcmpiadapter<my_sim_type,my_schecker_type> sim_type;
+    alps::mpi::communicator comm;
+    alps::params p;
+    sim_type::define_parameters(p);
+    p["async_progress"]=true;
+
+    sim_type sim(p, comm, my_schecker_type());
+    struct stop_now { bool operator()() const { return true; } };
+    EXPECT_FALSE(sim.run(stop_now()));
+    EXPECT_LT(sim.count(), int(sim_type::MAXCOUNT));
+}
+
+int main(int argc, char**argv)
+{
+   alps::mpi::environment env(argc, argv, false);
+   ::testing::InitGoogleTest(&argc, argv);
+   return RUN_ALL_TESTS();
+}
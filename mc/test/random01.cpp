@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file random01.cpp
+    Test the random number engines of random01, including the counter-based philox4x32
+*/
+
+#include <alps/mc/mcbase.hpp>
+#include <alps/mc/random01.hpp>
+#include <alps/mc/philox.hpp>
+
+#include <alps/testing/unique_file.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+// Known-answer tests of the Random123 distribution (kat_vectors)
+TEST(Philox, KnownAnswers) {
+    typedef alps::philox4x32 engine;
+    engine::counter_type out;
+    {
+        engine::counter_type ctr = { 0, 0, 0, 0 };
+        engine::key_type key = { 0, 0 };
+        engine::generate_block(ctr, key, out);
+        EXPECT_EQ(0x6627e8d5u, out[0]); EXPECT_EQ(0xe169c58du, out[1]);
+        EXPECT_EQ(0xbc57ac4cu, out[2]); EXPECT_EQ(0x9b00dbd8u, out[3]);
+    }
+    {
+        engine::counter_type ctr = { 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu };
+        engine::key_type key = { 0xffffffffu, 0xffffffffu };
+        engine::generate_block(ctr, key, out);
+        EXPECT_EQ(0x408f276du, out[0]); EXPECT_EQ(0x41c83b0eu, out[1]);
+        EXPECT_EQ(0xa20bc7c6u, out[2]); EXPECT_EQ(0x6d5451fdu, out[3]);
+    }
+    {
+        engine::counter_type ctr = { 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u };
+        engine::key_type key = { 0xa4093822u, 0x299f31d0u };
+        engine::generate_block(ctr, key, out);
+        EXPECT_EQ(0xd16cfe09u, out[0]); EXPECT_EQ(0x94fdccebu, out[1]);
+        EXPECT_EQ(0x5001e420u, out[2]); EXPECT_EQ(0x24126ea1u, out[3]);
+    }
+}
+
+TEST(Philox, Discard) {
+    alps::philox4x32 a(7, 3), b(7, 3);
+    for (int i = 0; i < 1001; ++i) a();
+    b.discard(1001);
+    EXPECT_EQ(a, b);
+    for (int i = 0; i < 10; ++i) EXPECT_EQ(a(), b());
+}
+
+TEST(Philox, BulkSameAsScalar) {
+    // start off a block boundary to exercise the head and tail loops
+    alps::philox4x32 a(7, 3), b(7, 3);
+    a(); b();
+    std::vector<double> scalar(1000), bulk(1000);
+    for (std::size_t i = 0; i < scalar.size(); ++i) scalar[i] = a.uniform();
+    b.uniform(&bulk[0], bulk.size());
+    EXPECT_EQ(scalar, bulk);
+    EXPECT_EQ(a, b);
+}
+
+TEST(Philox, Streams) {
+    alps::philox4x32 a(42, 0), b(42, 1);
+    int same = 0;
+    for (int i = 0; i < 100; ++i) same += (a() == b());
+    EXPECT_LT(same, 2);
+}
+
+TEST(Philox, Uniform) {
+    alps::philox4x32 a;
+    double sum = 0;
+    for (int i = 0; i < 100000; ++i) {
+        const double x = a.uniform();
+        ASSERT_GE(x, 0.);
+        ASSERT_LT(x, 1.);
+        sum += x;
+    }
+    EXPECT_NEAR(0.5, sum / 100000, 0.005);
+}
+
+TEST(Random01, MersenneTwisterUnchanged) {
+    alps::random01 old(45), rng(alps::random01::MT19937, 42, 3);
+    for (int i = 0; i < 10; ++i) EXPECT_EQ(old(), rng());
+}
+
+TEST(Random01, EngineFromName) {
+    EXPECT_EQ(alps::random01::MT19937, alps::random01::engine_from_name("mt19937"));
+    EXPECT_EQ(alps::random01::PHILOX4X32, alps::random01::engine_from_name("philox"));
+    EXPECT_THROW(alps::random01::engine_from_name("lcg"), std::invalid_argument);
+}
+
+class Random01SaveLoad : public ::testing::TestWithParam<alps::random01::engine_kind> {};
+
+TEST_P(Random01SaveLoad, SameSequence) {
+    alps::testing::unique_file ufile("random01.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    alps::random01 rng(GetParam(), 42, 5);
+    for (int i = 0; i < 13; ++i) rng();
+    {
+        alps::hdf5::archive ar(ufile.name(), "w");
+        ar["rng"] << rng;
+    }
+    alps::random01 loaded;
+    {
+        alps::hdf5::archive ar(ufile.name(), "r");
+        ar["rng"] >> loaded;
+    }
+    EXPECT_EQ(GetParam(), loaded.engine_type());
+    for (int i = 0; i < 10; ++i) EXPECT_EQ(rng(), loaded());
+}
+
+TEST_P(Random01SaveLoad, Buffered) {
+    alps::testing::unique_file ufile("random01_buffered.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    alps::random01 rng(GetParam(), 42, 5);
+    rng.set_buffer_size(64);
+    for (int i = 0; i < 13; ++i) rng();
+    {
+        alps::hdf5::archive ar(ufile.name(), "w");
+        ar["rng"] << rng;
+    }
+    alps::random01 loaded(GetParam(), 0, 0);
+    loaded.set_buffer_size(64);
+    {
+        alps::hdf5::archive ar(ufile.name(), "r");
+        ar["rng"] >> loaded;
+    }
+    if (GetParam() == alps::random01::PHILOX4X32) {
+        // exact resume
+        for (int i = 0; i < 100; ++i) EXPECT_EQ(rng(), loaded());
+    } else {
+        // resumes after the buffered block
+        rng.discard(64 - 13);
+        for (int i = 0; i < 100; ++i) EXPECT_EQ(rng(), loaded());
+    }
+}
+
+class Random01Engine : public ::testing::TestWithParam<alps::random01::engine_kind> {};
+
+TEST_P(Random01Engine, FillSameAsScalar) {
+    alps::random01 scalar(GetParam(), 42, 5), bulk(GetParam(), 42, 5);
+    scalar(); bulk();
+    std::vector<double> expected(1000), values(1000);
+    for (std::size_t i = 0; i < expected.size(); ++i) expected[i] = scalar();
+    bulk.fill(&values[0], values.size());
+    EXPECT_EQ(expected, values);
+    EXPECT_EQ(scalar(), bulk());
+}
+
+TEST_P(Random01Engine, BufferedSameAsScalar) {
+    alps::random01 scalar(GetParam(), 42, 5), buffered(GetParam(), 42, 5);
+    buffered.set_buffer_size(100);
+    EXPECT_EQ(100u, buffered.buffer_size());
+    for (int i = 0; i < 250; ++i) ASSERT_EQ(scalar(), buffered()) << i;
+    // fill() and discard() take the buffered numbers first
+    std::vector<double> expected(30), values(30);
+    for (std::size_t i = 0; i < expected.size(); ++i) expected[i] = scalar();
+    buffered.fill(&values[0], values.size());
+    EXPECT_EQ(expected, values);
+    scalar.discard(75);
+    buffered.discard(75);
+    for (int i = 0; i < 50; ++i) ASSERT_EQ(scalar(), buffered()) << i;
+}
+
+INSTANTIATE_TEST_CASE_P(Engines, Random01SaveLoad, ::testing::Values(alps::random01::MT19937, alps::random01::PHILOX4X32));
+INSTANTIATE_TEST_CASE_P(Engines, Random01Engine, ::testing::Values(alps::random01::MT19937, alps::random01::PHILOX4X32));
+
+/// Micro-benchmark: run with --gtest_also_run_disabled_tests
+TEST_P(Random01Engine, DISABLED_Benchmark) {
+    typedef std::chrono::steady_clock clock_type;
+    typedef std::chrono::duration<double, std::nano> ns;
+    const std::size_t n = 50000000, block = 1024;
+    std::vector<double> out(block);
+    double sum = 0;
+
+    alps::random01 scalar(GetParam(), 42, 0), bulk(GetParam(), 42, 0), buffered(GetParam(), 42, 0);
+    buffered.set_buffer_size(block);
+
+    clock_type::time_point t0 = clock_type::now();
+    for (std::size_t i = 0; i < n; ++i) sum += scalar();
+    clock_type::time_point t1 = clock_type::now();
+    for (std::size_t i = 0; i < n; i += block) {
+        bulk.fill(&out[0], block);
+        for (std::size_t k = 0; k < block; ++k) sum += out[k];
+    }
+    clock_type::time_point t2 = clock_type::now();
+    for (std::size_t i = 0; i < n; ++i) sum += buffered();
+    clock_type::time_point t3 = clock_type::now();
+
+    std::cout << "ns/number: scalar " << ns(t1 - t0).count() / n
+              << ", fill " << ns(t2 - t1).count() / n
+              << ", buffered " << ns(t3 - t2).count() / n
+              << " (checksum " << sum << ")" << std::endl;
+}
+
+// Simulation exposing its random number generator
+class rng_sim : public alps::mcbase {
+  public:
+    rng_sim(parameters_type const & p, std::size_t seed_offset) : alps::mcbase(p, seed_offset) {}
+    void update() {}
+    void measure() {}
+    double fraction_completed() const { return 1.; }
+    alps::random01 & rng() { return random; }
+};
+
+TEST(Random01, EngineParameter) {
+    alps::params p;
+    alps::mcbase::define_parameters(p);
+    EXPECT_EQ(alps::random01::MT19937, rng_sim(p, 0).rng().engine_type());
+
+    p["RNG"] = std::string("philox");
+    rng_sim sim0(p, 0), sim1(p, 1);
+    EXPECT_EQ(alps::random01::PHILOX4X32, sim0.rng().engine_type());
+    // the seed offset selects the stream
+    alps::philox4x32 stream1(42, 1);
+    EXPECT_EQ(stream1.uniform(), sim1.rng()());
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 1998-2018 ALPS Collaboration. See COPYRIGHT.TXT
+ * All rights reserved. Use is subject to license terms. See LICENSE.TXT
+ * For use in publications, see ACKNOWLEDGE.TXT
+ */
+
+/** @file thread_adapter.cpp
+    Test the shared-memory adapter mcthreadadapter
+*/
+
+#include <alps/mc/mcbase.hpp>
+#include <alps/mc/threadadapter.hpp>
+#include <alps/mc/api.hpp>
+
+#include <alps/testing/unique_file.hpp>
+
+#include <gtest/gtest.h>
+
+// Simulation measuring uniform random numbers
+class my_sim_type : public alps::mcbase {
+    int count_;
+    int total_count_;
+    std::size_t offset_;
+  public:
+    my_sim_type(const parameters_type& p, std::size_t offset=0)
+        : alps::mcbase(p,offset), count_(0), total_count_(p["COUNT"]), offset_(offset)
+    {
+        measurements << alps::accumulators::LogBinningAccumulator<double>("X");
+    }
+
+    static parameters_type& define_parameters(parameters_type & parameters) {
+        alps::mcbase::define_parameters(parameters);
+        return parameters.define<int>("COUNT", 4000, "total number of steps");
+    }
+
+    void update() {
+        if (count_<0) throw std::runtime_error("Negative count");
+        ++count_;
+    }
+
+    void measure() { measurements["X"] << random(); }
+
+    double fraction_completed() const { return count_/double(total_count_); }
+
+    int count() const { return count_; }
+    void set_count(int count) { count_=count; }
+
+    void save(alps::hdf5::archive & ar) const {
+        alps::mcbase::save(ar);
+        ar["count"] << count_;
+        ar["offset"] << offset_;
+    }
+
+    void load(alps::hdf5::archive & ar) {
+        alps::mcbase::load(ar);
+        ar["count"] >> count_;
+    }
+};
+
+typedef alps::mcthreadadapter<my_sim_type> sim_type;
+
+static bool stop_callback() { return false; }
+
+class ThreadAdapterTest : public ::testing::Test {
+  public:
+    alps::params p;
+    ThreadAdapterTest() { sim_type::define_parameters(p); }
+};
+
+TEST_F(ThreadAdapterTest, Run) {
+    sim_type sim(p, 4);
+    EXPECT_EQ(4u, sim.num_threads());
+    EXPECT_EQ(0., sim.fraction_completed());
+
+    EXPECT_TRUE(sim.run(stop_callback));
+    EXPECT_GE(sim.fraction_completed(), 1.);
+
+    alps::accumulators::result_set results = sim.collect_results();
+    const alps::accumulators::result_wrapper& x = results["X"];
+    // every clone measured; together at least COUNT steps
+    EXPECT_GE(x.count(), 4000u);
+    EXPECT_GE(x.count(), boost::uint64_t(sim.count()));
+    EXPECT_NEAR(0.5, x.mean<double>(), 0.05);
+}
+
+TEST_F(ThreadAdapterTest, Stop) {
+    sim_type sim(p, 3);
+    struct stop_now { bool operator()() const { return true; } };
+    EXPECT_FALSE(sim.run(stop_now()));
+    EXPECT_EQ(0, sim.count());
+}
+
+TEST_F(ThreadAdapterTest, Exception) {
+    sim_type sim(p, 2);
+    sim.set_count(-10);
+    EXPECT_THROW(sim.run(stop_callback), std::runtime_error);
+}
+
+TEST_F(ThreadAdapterTest, SingleThread) {
+    sim_type sim(p, 1);
+    EXPECT_TRUE(sim.run(stop_callback));
+    EXPECT_EQ(4000, sim.count());
+    EXPECT_EQ(4000u, sim.collect_results()["X"].count());
+}
+
+TEST_F(ThreadAdapterTest, SaveLoad) {
+    alps::testing::unique_file ufile("thread_adapter.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    sim_type sim(p, 2);
+    sim.run(stop_callback);
+    const boost::uint64_t count=sim.collect_results()["X"].count();
+    const double fraction=sim.fraction_completed();
+    sim.save(ufile.name());
+
+    sim_type sim2(p, 2);
+    sim2.load(ufile.name());
+    EXPECT_EQ(fraction, sim2.fraction_completed());
+    EXPECT_EQ(count, sim2.collect_results()["X"].count());
+}
+
+TEST_F(ThreadAdapterTest, SaveAsync) {
+    alps::testing::unique_file ufile("thread_adapter_async.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    sim_type sim(p, 3);
+    sim.run(stop_callback);
+    const boost::uint64_t count=sim.collect_results()["X"].count();
+    sim.save_async(ufile.name());
+    sim.wait_for_save();
+
+    sim_type sim2(p, 3);
+    sim2.load(ufile.name());
+    EXPECT_EQ(count, sim2.collect_results()["X"].count());
+}
+
+TEST_F(ThreadAdapterTest, Seeds) {
+    alps::testing::unique_file ufile("thread_adapter_seeds.h5.", alps::testing::unique_file::REMOVE_AFTER);
+    sim_type sim(p, 3, 1000, 7);
+    sim.save(ufile.name());
+
+    alps::hdf5::archive ar(ufile.name(), "r");
+    for (std::size_t i=0; i<3; ++i) {
+        std::size_t offset;
+        ar["/simulation/realizations/0/clones/"+std::to_string(i)+"/offset"] >> offset;
+        EXPECT_EQ(i*1000+7, offset);
+    }
+}
@@ -43,6 +43,10 @@ ising_sim::ising_sim(parameters_type const & parms, std::size_t seed_offset)
     , current_magnetization(0)
     , iexp_(-beta)
 {
+    // Draws random numbers from a block refilled at once:
+    // update() needs up to three of them per step
+    random.set_buffer_size(1024);
+
     // Initializes the spins
     for(int i=0; i<length; ++i) {
         for (int j=0; j<length; ++j) {
@@ -13,6 +13,7 @@
 #include <alps/utilities/stacktrace.hpp>
 
 #include <alps/numeric/inf.hpp>
+#include <alps/numeric/check_size.hpp>
 #include <alps/numeric/special_functions.hpp>
 
 #include <boost/accumulators/numeric/functional/vector.hpp> 
@@ -362,6 +363,75 @@ namespace alps {
                            plus<T,T,T>());
             return left;
         }
+
+        //------------------- in-place kernels -------------------
+        // These kernels modify their first argument in place. The vector versions
+        // act element-wise (recursively for vectors of vectors) and treat a
+        // default-initialized (size 0) first argument as a 0-vector, resizing it;
+        // otherwise they do not allocate.
+
+        /// y += a*x
+        template<typename T, typename S>
+        inline void axpy(T & y, S const & a, T const & x) {
+            y += a * x;
+        }
+        /// y[0..n) += a*x[0..n), element-wise; the ranges may be equal but must not overlap otherwise
+        template<typename T, typename S>
+        inline void axpy(T * y, S const & a, T const * x, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                axpy(y[i], a, x[i]);
+        }
+        /// y += a*x, element-wise
+        template<typename T, typename S>
+        inline void axpy(std::vector<T> & y, S const & a, std::vector<T> const & x) {
+            check_size(y, x);
+            axpy(y.data(), a, x.data(), y.size());
+        }
+
+        /// y += x*x
+        template<typename T>
+        inline void add_sq_inplace(T & y, T const & x) {
+            y += x * x;
+        }
+        /// y += x*x, element-wise
+        template<typename T>
+        inline void add_sq_inplace(std::vector<T> & y, std::vector<T> const & x) {
+            check_size(y, x);
+            T * py = y.data();
+            T const * px = x.data();
+            const std::size_t n = y.size();
+            for (std::size_t i = 0; i < n; ++i)
+                add_sq_inplace(py[i], px[i]);
+        }
+
+        /// y *= a
+        template<typename T, typename S>
+        inline void scale_inplace(T & y, S const & a) {
+            y *= a;
+        }
+        /// y[0..n) *= a, element-wise
+        template<typename T, typename S>
+        inline void scale_inplace(T * y, S const & a, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                scale_inplace(y[i], a);
+        }
+        /// y *= a, element-wise
+        template<typename T, typename S>
+        inline void scale_inplace(std::vector<T> & y, S const & a) {
+            scale_inplace(y.data(), a, y.size());
+        }
+
+        /// y = 0, keeping the size of y
+        template<typename T>
+        inline void set_zero(T & y) {
+            y = T();
+        }
+        /// y = 0 element-wise, keeping the size of y
+        template<typename T>
+        inline void set_zero(std::vector<T> & y) {
+            for (typename std::vector<T>::iterator it = y.begin(); it != y.end(); ++it)
+                set_zero(*it);
+        }
     }
 }
 
@@ -394,6 +394,29 @@ namespace alps {
             return out_val;
         }
 
+#if MPI_VERSION >= 3
+        /// Starts a non-blocking `MPI_Iallreduce` for a primitive type T
+        /** @note `val` and `out_val` must stay alive until the request completes; `out_val` is valid only after that. */
+        template <typename T, typename OP>
+        MPI_Request i_all_reduce(const alps::mpi::communicator& comm, const T& val,
+                                 T& out_val, const OP& /*op*/)
+        {
+            MPI_Request req;
+            MPI_Iallreduce(const_cast<T*>(&val), &out_val, 1, detail::mpi_type<T>(),
+                           is_mpi_op<OP,T>::op(), comm, &req);
+            return req;
+        }
+#endif /* MPI_VERSION >= 3 */
+
+        /// Checks whether a non-blocking operation has completed, without blocking
+        /** @note On completion the request is reset to `MPI_REQUEST_NULL` */
+        inline bool test(MPI_Request& req)
+        {
+            int flag=0;
+            MPI_Test(&req, &flag, MPI_STATUS_IGNORE);
+            return flag!=0;
+        }
+
     } // mpi::
 } // alps::
 
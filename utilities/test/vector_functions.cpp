@@ -162,3 +162,80 @@ TYPED_TEST(VectorFunctionsTest, testMergeToLarger) {
     ASSERT_EQ(5u,vec1.size());
     EXPECT_EQ(res, vec1);
 }
+
+TYPED_TEST(VectorFunctionsTest, testAxpy) {
+    typedef typename TestFixture::value_type value_type;
+    using alps::numeric::axpy;
+    value_type vec1=gen_data<value_type>(2.25);
+    const value_type vec2=gen_data<value_type>(1.50);
+    value_type res=gen_data<value_type>(2.25+0.5*1.50);
+    axpy(vec1, 0.5, vec2);
+    ASSERT_EQ(res.size(),vec1.size());
+    EXPECT_EQ(res, vec1);
+}
+
+TYPED_TEST(VectorFunctionsTest, testAddSqInplace) {
+    typedef typename TestFixture::value_type value_type;
+    using alps::numeric::add_sq_inplace;
+    value_type vec1=gen_data<value_type>(2.25);
+    const value_type vec2=gen_data<value_type>(1.50);
+    value_type res=gen_data<value_type>(2.25+1.50*1.50);
+    add_sq_inplace(vec1, vec2);
+    ASSERT_EQ(res.size(),vec1.size());
+    EXPECT_EQ(res, vec1);
+}
+
+TYPED_TEST(VectorFunctionsTest, testAddSqInplaceToEmpty) {
+    typedef typename TestFixture::value_type value_type;
+    using alps::numeric::add_sq_inplace;
+    value_type vec1;
+    const value_type vec2=gen_data<value_type>(1.50);
+    value_type res=gen_data<value_type>(1.50*1.50);
+    add_sq_inplace(vec1, vec2);
+    ASSERT_EQ(res.size(),vec1.size());
+    EXPECT_EQ(res, vec1);
+}
+
+TYPED_TEST(VectorFunctionsTest, testInplaceSizeMismatch) {
+    typedef typename TestFixture::value_type value_type;
+    using alps::numeric::axpy;
+    using alps::numeric::add_sq_inplace;
+    value_type vec1=gen_data<value_type>(2.25,5);
+    const value_type vec2=gen_data<value_type>(1.50,4);
+    EXPECT_ANY_THROW(axpy(vec1, 0.5, vec2));
+    EXPECT_ANY_THROW(add_sq_inplace(vec1, vec2));
+}
+
+TYPED_TEST(VectorFunctionsTest, testScaleInplace) {
+    typedef typename TestFixture::value_type value_type;
+    using alps::numeric::scale_inplace;
+    value_type vec1=gen_data<value_type>(2.25);
+    value_type res=gen_data<value_type>(2.25*1.50);
+    scale_inplace(vec1, 1.50);
+    ASSERT_EQ(res.size(),vec1.size());
+    EXPECT_EQ(res, vec1);
+}
+
+TYPED_TEST(VectorFunctionsTest, testRangeKernels) {
+    typedef typename TestFixture::value_type value_type;
+    using alps::numeric::axpy;
+    using alps::numeric::scale_inplace;
+    value_type vec1=gen_data<value_type>(2.25);
+    const value_type vec2=gen_data<value_type>(1.50);
+    value_type res=gen_data<value_type>((2.25+0.5*1.50)*1.50);
+    res[0]=vec1[0];
+    // leave the first element alone
+    axpy(vec1.data()+1, 0.5, vec2.data()+1, vec1.size()-1);
+    scale_inplace(vec1.data()+1, 1.50, vec1.size()-1);
+    EXPECT_EQ(res, vec1);
+}
+
+TYPED_TEST(VectorFunctionsTest, testSetZero) {
+    typedef typename TestFixture::value_type value_type;
+    using alps::numeric::set_zero;
+    value_type vec1=gen_data<value_type>(2.25);
+    value_type res=gen_data<value_type>(0.);
+    set_zero(vec1);
+    ASSERT_EQ(res.size(),vec1.size());
+    EXPECT_EQ(res, vec1);
+}